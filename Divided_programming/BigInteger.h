@@ -0,0 +1,320 @@
+#ifndef BIGINTEGER_H
+#define BIGINTEGER_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <memory>
+#include <utility>
+#if __cplusplus >= 202002L
+#include <compare>
+#endif
+
+// 运算统计：各档算法的调用次数与操作数规模、各档内的内存分配，以及数字存储的当前量和峰值，
+// 供调用方做性能分析（如 pi 的 --stats）。
+// 计数器按线程存放，只由所属线程写入（relaxed 读写，无原子读改写、不与其他线程争用缓存行），
+// 读取时汇总所有线程；当前内存量在线程内累积到 LIVE_BYTES_BATCH 才并入全局值并更新峰值，
+// 峰值的误差不超过每线程一个批量。分配计入当前线程最内层正在执行的算法档，档外的计入 Other
+enum class OpTier { Other, MulSchoolbook, MulKaratsuba, DivShort, DivSchoolbook, DivNewton, Count };
+
+struct TierCounts {
+    unsigned long long calls = 0;
+    unsigned long long operandDigits = 0;
+    unsigned long long allocations = 0;
+    unsigned long long allocatedBytes = 0;
+};
+
+struct OpStats {
+    static const long long LIVE_BYTES_BATCH = 64 * 1024;
+
+    // 在作用域内把当前线程的分配计入 tier，并记一次该档的调用；可嵌套，退出时恢复外层
+    class TierScope {
+    private:
+        OpTier saved;
+
+    public:
+        TierScope(OpTier tier, size_t operandDigits);
+        ~TierScope();
+        TierScope(const TierScope&) = delete;
+        TierScope& operator=(const TierScope&) = delete;
+    };
+
+    // 分配器钩子
+    static void onAllocate(size_t bytes);
+
+    static void onDeallocate(size_t bytes);
+
+    // 汇总所有线程（含已退出线程）的计数
+    static TierCounts total(OpTier tier);
+
+    static long long peakBytes();
+
+    // 区间峰值：自上次 restartInterval 以来的最大内存量，调用方可按阶段分段统计
+    static long long intervalPeakBytes();
+
+    static void restartInterval();
+};
+
+// 统计内存分配的分配器，用于 BigInteger 的数字存储
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        OpStats::onAllocate(n * sizeof(T));
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) {
+        OpStats::onDeallocate(n * sizeof(T));
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+// 乘法模校验（--verify）发现乘积与模余数不一致时抛出，表示发生了运算错误
+class ProductCheckError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// 自定义大整数类
+class BigInteger {
+private:
+    std::vector<int, CountingAllocator<int>> digits; // 按位存储，低位在前
+    bool negative;           // 符号位
+
+    // 乘法/除法算法分档的切换阈值（位数），可由 --tune 生成的调优文件覆盖
+    static int karatsubaThreshold;
+    static int newtonDivisionThreshold;
+    static int parallelAddThreshold;
+    static unsigned parallelAddThreads; // 0 表示使用硬件线程数
+
+    // 乘以 10^k（在低位插入k个0）
+    BigInteger shiftedLeft(size_t k) const;
+
+    // 除以 10^k 并向零截断（去掉低k位）
+    BigInteger shiftedRight(size_t k) const;
+
+    // 取第 [from, to) 位组成的非负数
+    BigInteger digitRange(size_t from, size_t to) const;
+
+    // 绝对值转为 2^30 进制，低位在前
+    std::vector<unsigned> toBinaryLimbs() const;
+
+    static BigInteger fromBinaryLimbs(const std::vector<unsigned>& limbs);
+
+    template <typename Op>
+    BigInteger bitwise(const BigInteger& other, Op op) const;
+
+    // 超大操作数的分块并行加减（a 为较长/绝对值较大者）。
+    // 各块先按进位（借位）输入为0计算，记录块的进位输出 generate 以及进位输入为1时
+    // 是否会穿过整块 propagate（加法时块内全为9，减法时全为0），即两种进位输入下的输出；
+    // 再对块做前缀扫描得到实际进位输入，最后各线程只修正收到进位的块
+    template <bool Subtract>
+    static void addSubtractParallel(const BigInteger& a, const BigInteger& b, BigInteger& result, unsigned threads);
+
+    // 并行加减的线程数，硬件线程数只查询一次
+    static unsigned parallelAddThreadCount();
+
+    // |a| + |b|，单遍进位，结果按最终长度一次分配
+    static BigInteger addMagnitude(const BigInteger& a, const BigInteger& b);
+
+    // |a| - |b|，要求 |a| ≥ |b|
+    static BigInteger subtractMagnitude(const BigInteger& a, const BigInteger& b);
+
+    // 计算 a ± |b|（bNegative 为 b 参与运算时的符号），加减法统一入口：至多一次绝对值比较，不复制操作数
+    static BigInteger addSigned(const BigInteger& a, const BigInteger& b, bool bNegative);
+
+    bool isZero() const {
+        return digits.size() == 1 && digits[0] == 0;
+    }
+
+    // 朴素乘法（忽略符号）
+    static BigInteger multiplySchoolbook(const BigInteger& a, const BigInteger& b);
+
+    // 按位数在朴素乘法和Karatsuba之间分派（忽略符号）
+    static BigInteger multiplyMagnitude(const BigInteger& a, const BigInteger& b);
+
+    // out += x·10^offset（subtract 时为减），原地处理进位/借位；调用方保证 out 足够长且结果非负
+    static void accumulateShifted(std::vector<int, CountingAllocator<int>>& out, const BigInteger& x, size_t offset, bool subtract);
+
+    // 逐位试商的长除法（a、b 均非负）
+    static void divideSchoolbook(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+
+    // 牛顿倒数内层的保护位数，以及商的最大修正次数
+    static const size_t RECIPROCAL_GUARD_DIGITS = 4;
+    static const int MAX_NEWTON_CORRECTIONS = 8;
+
+    // 牛顿迭代求倒数：b 有 m 位，返回 10^(m-1+p)/b 的近似值（约p位），精度逐次加倍
+    static BigInteger reciprocal(const BigInteger& b, size_t p);
+
+    // 用牛顿倒数把除法化为乘法（a、b 均非负，a ≥ b）
+    static void divideNewton(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+
+public:
+    // 构造函数
+    BigInteger() : negative(false) {
+        digits.push_back(0);
+    }
+
+    BigInteger(long long num);
+
+    BigInteger(const std::string& str);
+
+    // 去除前导零
+    void removeLeadingZeros();
+
+    // 转换为字符串
+    std::string toString() const;
+
+    // 加法
+    BigInteger operator+(const BigInteger& other) const {
+        return addSigned(*this, other, other.negative);
+    }
+
+    // 减法
+    BigInteger operator-(const BigInteger& other) const {
+        return addSigned(*this, other, !other.negative);
+    }
+
+    // 乘法
+    BigInteger operator*(const BigInteger& other) const;
+
+    // 除法
+    std::pair<BigInteger, BigInteger> divmod(const BigInteger& divisor) const;
+
+    BigInteger operator/(const BigInteger& other) const {
+        return divmod(other).first;
+    }
+
+    BigInteger operator%(const BigInteger& other) const {
+        return divmod(other).second;
+    }
+
+    // 比较绝对值，返回 -1/0/1，单遍
+    static int compareMagnitude(const BigInteger& a, const BigInteger& b);
+
+    // 三路比较，返回 -1/0/1；零总是非负，所以符号不同即可判定
+    int compare(const BigInteger& other) const;
+
+#if __cplusplus >= 202002L
+    std::strong_ordering operator<=>(const BigInteger& other) const {
+        return compare(other) <=> 0;
+    }
+#endif
+
+    // 比较运算符
+    bool operator<(const BigInteger& other) const {
+        return compare(other) < 0;
+    }
+
+    bool operator<=(const BigInteger& other) const {
+        return compare(other) <= 0;
+    }
+
+    bool operator>(const BigInteger& other) const {
+        return compare(other) > 0;
+    }
+
+    bool operator>=(const BigInteger& other) const {
+        return compare(other) >= 0;
+    }
+
+    bool operator==(const BigInteger& other) const;
+
+    bool operator!=(const BigInteger& other) const {
+        return !(*this == other);
+    }
+
+    // 位数（十进制，即limb数）
+    size_t digitCount() const {
+        return digits.size();
+    }
+
+    // 乘以 10^n（n<0 时除以 10^-n 并向零截断），只移动数字，线性时间
+    BigInteger scaleByPow10(long long n) const {
+        return n >= 0 ? shiftedLeft((size_t)n) : shiftedRight((size_t)-n);
+    }
+
+    // 乘以小整数（0 ≤ factor < 2^31），单遍线性
+    BigInteger multiplySmall(long long factor) const;
+
+    // 除以小整数（0 < divisor < 2^31），向零截断，单遍线性；remainder 与被除数同号
+    BigInteger divideSmall(long long divisor, long long* remainder = nullptr) const;
+
+    // 除以2（向零截断）
+    BigInteger half() const {
+        return divideSmall(2);
+    }
+
+    // 按绝对值移位：<< 乘以 2^bits，>> 除以 2^bits 并向零截断，保持符号；bits 为负时反向移位。
+    // 十进制存储下每29位做一遍线性的小整数乘除
+    BigInteger operator<<(int bits) const;
+
+    BigInteger operator>>(int bits) const;
+
+    // 按位与/或（仅支持非负数）。需要先转换为二进制，代价为平方级
+    BigInteger operator&(const BigInteger& other) const;
+
+    BigInteger operator|(const BigInteger& other) const;
+
+    // 绝对值的二进制位数（0 的位数为 0）
+    long long bitLength() const;
+
+    // 绝对值二进制表示中1的个数
+    long long popcount() const;
+
+    // 二进制序列化：1字节符号、8字节小端位数，其后每字节压缩两位十进制数字（低位在低半字节）
+    void serialize(std::ostream& out) const;
+
+    static BigInteger deserialize(std::istream& in);
+
+    // 对小素数取模（p < 2^31），用于乘法校验
+    long long modSmall(long long p) const;
+
+    // 开启乘法模校验：此后对足够大的乘积用随机选取的 primeCount 个 [2^30, 2^31) 内的素数
+    // 检查 (a mod p)(b mod p) ≡ ab，不一致时抛出 ProductCheckError
+    static void enableProductCheck(int primeCount = 3);
+
+    // 已完成的乘法模校验次数
+    static unsigned long long productChecks();
+
+    // 算法切换阈值
+    static int getKaratsubaThreshold() { return karatsubaThreshold; }
+    static int getNewtonDivisionThreshold() { return newtonDivisionThreshold; }
+    static void setKaratsubaThreshold(int digits) { karatsubaThreshold = std::max(digits, 4); }
+    static void setNewtonDivisionThreshold(int digits) { newtonDivisionThreshold = std::max(digits, 20); }
+    static int getParallelAddThreshold() { return parallelAddThreshold; }
+    static void setParallelAddThreshold(int digits) { parallelAddThreshold = std::max(digits, 1024); }
+    static void setParallelAddThreads(unsigned threads) { parallelAddThreads = threads; }
+
+    // 从调优文件读取阈值（每行 key=value），文件不存在时返回false
+    static bool loadTuning(const std::string& path);
+
+    static bool saveTuning(const std::string& path);
+
+    // 求幂
+    BigInteger pow(int exponent) const;
+};
+
+// 定义平方根函数（使用牛顿迭代法）
+BigInteger sqrt(const BigInteger& n);
+
+// 辅助函数：阶乘计算
+BigInteger factorial(int n);
+
+// 使用二项式系数计算阶乘组合
+BigInteger binomialCoefficient(int n, int k);
+
+#endif // BIGINTEGER_H
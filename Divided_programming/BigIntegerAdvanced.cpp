@@ -1,30 +1,53 @@
 #include "BigInteger.h"
 #include <stdexcept>
 
-// 除法
-std::pair<BigInteger, BigInteger> BigInteger::divmod(const BigInteger& divisor) const {
-    if (divisor.digits.size() == 1 && divisor.digits[0] == 0) {
-        throw std::runtime_error("Division by zero");
+// 绝对值转为 2^30 进制，低位在前
+std::vector<unsigned> BigInteger::toBinaryLimbs() const {
+    std::vector<unsigned> limbs;
+    BigInteger rest = *this;
+    rest.negative = false;
+    while (!(rest.digits.size() == 1 && rest.digits[0] == 0)) {
+        long long rem = 0;
+        rest = rest.divideSmall(1LL << 30, &rem);
+        limbs.push_back((unsigned)rem);
     }
+    return limbs;
+}
 
-    if (*this < divisor) {
-        return { BigInteger(0), *this };
+BigInteger BigInteger::fromBinaryLimbs(const std::vector<unsigned>& limbs) {
+    BigInteger result(0);
+    for (int i = limbs.size() - 1; i >= 0; --i) {
+        result = result.multiplySmall(1LL << 30) + BigInteger((long long)limbs[i]);
     }
+    return result;
+}
 
-    BigInteger a = *this;
-    BigInteger b = divisor;
-    a.negative = false;
-    b.negative = false;
-
-    BigInteger quotient;
-    BigInteger remainder;
+template <typename Op>
+BigInteger BigInteger::bitwise(const BigInteger& other, Op op) const {
+    if (negative || other.negative) {
+        throw std::runtime_error("按位运算只支持非负数");
+    }
+    std::vector<unsigned> a = toBinaryLimbs();
+    std::vector<unsigned> b = other.toBinaryLimbs();
+    a.resize(std::max(a.size(), b.size()), 0);
+    b.resize(a.size(), 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = op(a[i], b[i]);
+    }
+    return fromBinaryLimbs(a);
+}
 
+// 逐位试商的长除法（a、b 均非负）
+void BigInteger::divideSchoolbook(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder) {
+    OpStats::TierScope tier(OpTier::DivSchoolbook, a.digits.size() + b.digits.size());
+    quotient = BigInteger();
+    remainder = BigInteger();
     quotient.digits.resize(a.digits.size(), 0);
-
+    
     for (int i = a.digits.size() - 1; i >= 0; --i) {
         remainder.digits.insert(remainder.digits.begin(), a.digits[i]);
         remainder.removeLeadingZeros();
-
+        
         int q = 0;
         int l = 0, r = 9;
         while (l <= r) {
@@ -37,47 +60,172 @@ std::pair<BigInteger, BigInteger> BigInteger::divmod(const BigInteger& divisor)
                 r = mid - 1;
             }
         }
-
+        
         quotient.digits[i] = q;
         remainder = remainder - b * BigInteger(q);
     }
-
+    
     quotient.removeLeadingZeros();
-    quotient.negative = negative != divisor.negative;
-    remainder.negative = negative;
-
-    return { quotient, remainder };
 }
 
-BigInteger BigInteger::operator/(const BigInteger& other) const {
-    return divmod(other).first;
+// 牛顿迭代求倒数：b 有 m 位，返回 10^(m-1+p)/b 的近似值（约p位），精度逐次加倍。
+// 内层多算 RECIPROCAL_GUARD_DIGITS 位，使上一层末位的误差平方后仍落在本层末位之下
+BigInteger BigInteger::reciprocal(const BigInteger& b, size_t p) {
+    size_t m = b.digits.size();
+    
+    if (p <= 16) {
+        size_t s = m > p + 3 ? m - (p + 3) : 0;
+        BigInteger bt = b.shiftedRight(s);
+        BigInteger quotient, remainder;
+        divideSchoolbook(BigInteger(1).shiftedLeft(m - s - 1 + p), bt, quotient, remainder);
+        return quotient;
+    }
+    
+    size_t h = p / 2 + RECIPROCAL_GUARD_DIGITS;
+    BigInteger y = reciprocal(b, h);
+    
+    // 只用b的高 p+保护位 做本轮迭代
+    size_t s = m > p + RECIPROCAL_GUARD_DIGITS ? m - (p + RECIPROCAL_GUARD_DIGITS) : 0;
+    BigInteger bt = b.shiftedRight(s);
+    size_t scale = m - s - 1 + p;
+    
+    BigInteger Y = y.shiftedLeft(p - h);
+    BigInteger e = BigInteger(1).shiftedLeft(scale) - bt * Y;
+    return Y + (Y * e).shiftedRight(scale);
 }
 
-BigInteger BigInteger::operator%(const BigInteger& other) const {
-    return divmod(other).second;
+// 用牛顿倒数把除法化为乘法（a、b 均非负，a ≥ b）
+void BigInteger::divideNewton(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder) {
+    OpStats::TierScope tier(OpTier::DivNewton, a.digits.size() + b.digits.size());
+    size_t n = a.digits.size();
+    size_t m = b.digits.size();
+    size_t p = n - m + 2;
+    
+    BigInteger inverse = reciprocal(b, p);
+    quotient = (a * inverse).shiftedRight(m - 1 + p);
+    remainder = a - quotient * b;
+    
+    // 倒数只精确到末位附近，商最多差几个单位；修正次数超出上限说明近似失效，退回长除法
+    int corrections = 0;
+    while (remainder.negative && corrections++ < MAX_NEWTON_CORRECTIONS) {
+        quotient = quotient - BigInteger(1);
+        remainder = remainder + b;
+    }
+    while (!remainder.negative && !(remainder < b) && corrections++ < MAX_NEWTON_CORRECTIONS) {
+        quotient = quotient + BigInteger(1);
+        remainder = remainder - b;
+    }
+    if (remainder.negative || !(remainder < b)) {
+        divideSchoolbook(a, b, quotient, remainder);
+    }
 }
 
-// 相等和不等运算符
-bool BigInteger::operator==(const BigInteger& other) const {
-    if (negative != other.negative) {
-        return false;
+// 除法
+std::pair<BigInteger, BigInteger> BigInteger::divmod(const BigInteger& divisor) const {
+    if (divisor.digits.size() == 1 && divisor.digits[0] == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    
+    // 按绝对值比较，否则负数被除数会被误判为小于除数
+    if (compareMagnitude(*this, divisor) < 0) {
+        return { BigInteger(0), *this };
     }
+    
+    BigInteger a = *this;
+    BigInteger b = divisor;
+    a.negative = false;
+    b.negative = false;
+    
+    // 除数不超过9位时使用逐位短除法，线性时间
+    if (b.digits.size() <= 9) {
+        OpStats::TierScope tier(OpTier::DivShort, a.digits.size() + b.digits.size());
+        long long d = 0;
+        for (int i = b.digits.size() - 1; i >= 0; --i) {
+            d = d * 10 + b.digits[i];
+        }
+        
+        long long rem = 0;
+        BigInteger quotient = a.divideSmall(d, &rem);
+        
+        quotient.removeLeadingZeros();
+        quotient.negative = negative != divisor.negative;
+        BigInteger remainder(rem);
+        remainder.negative = negative && rem != 0;
+        return { quotient, remainder };
+    }
+    
+    BigInteger quotient;
+    BigInteger remainder;
+    
+    if (b.digits.size() >= (size_t)newtonDivisionThreshold) {
+        divideNewton(a, b, quotient, remainder);
+    } else {
+        divideSchoolbook(a, b, quotient, remainder);
+    }
+    
+    quotient.negative = negative != divisor.negative;
+    quotient.removeLeadingZeros();
+    remainder.negative = negative;
+    remainder.removeLeadingZeros();
+    
+    return { quotient, remainder };
+}
 
-    if (digits.size() != other.digits.size()) {
-        return false;
+// 按绝对值移位：<< 乘以 2^bits，>> 除以 2^bits 并向零截断，保持符号；bits 为负时反向移位。
+// 十进制存储下每29位做一遍线性的小整数乘除
+BigInteger BigInteger::operator<<(int bits) const {
+    if (bits < 0) {
+        return (*this >> -(bits + 1)) >> 1; // 分两步，避免对 INT_MIN 取负溢出
+    }
+    BigInteger result = *this;
+    for (; bits > 0; bits -= 29) {
+        result = result.multiplySmall(1LL << std::min(bits, 29));
     }
+    return result;
+}
 
-    for (size_t i = 0; i < digits.size(); ++i) {
-        if (digits[i] != other.digits[i]) {
-            return false;
-        }
+BigInteger BigInteger::operator>>(int bits) const {
+    if (bits < 0) {
+        return (*this << -(bits + 1)) << 1;
+    }
+    BigInteger result = *this;
+    for (; bits > 0; bits -= 29) {
+        result = result.divideSmall(1LL << std::min(bits, 29));
     }
+    return result;
+}
+
+// 按位与/或（仅支持非负数）。需要先转换为二进制，代价为平方级
+BigInteger BigInteger::operator&(const BigInteger& other) const {
+    return bitwise(other, [](unsigned a, unsigned b) { return a & b; });
+}
+
+BigInteger BigInteger::operator|(const BigInteger& other) const {
+    return bitwise(other, [](unsigned a, unsigned b) { return a | b; });
+}
 
-    return true;
+// 绝对值的二进制位数（0 的位数为 0）
+long long BigInteger::bitLength() const {
+    std::vector<unsigned> limbs = toBinaryLimbs();
+    if (limbs.empty()) {
+        return 0;
+    }
+    long long bits = 30LL * (limbs.size() - 1);
+    for (unsigned top = limbs.back(); top; top >>= 1) {
+        ++bits;
+    }
+    return bits;
 }
 
-bool BigInteger::operator!=(const BigInteger& other) const {
-    return !(*this == other);
+// 绝对值二进制表示中1的个数
+long long BigInteger::popcount() const {
+    long long count = 0;
+    for (unsigned limb : toBinaryLimbs()) {
+        for (; limb; limb &= limb - 1) {
+            ++count;
+        }
+    }
+    return count;
 }
 
 // 求幂
@@ -85,19 +233,65 @@ BigInteger BigInteger::pow(int exponent) const {
     if (exponent < 0) {
         throw std::runtime_error("Negative exponent not supported");
     }
-
+    
     if (exponent == 0) {
         return BigInteger(1);
     }
-
+    
     if (exponent == 1) {
         return *this;
     }
-
+    
     if (exponent % 2 == 0) {
         BigInteger half = pow(exponent / 2);
         return half * half;
     } else {
         return *this * pow(exponent - 1);
     }
-}
\ No newline at end of file
+}
+
+// 定义平方根函数（使用牛顿迭代法）
+BigInteger sqrt(const BigInteger& n) {
+    if (n <= BigInteger(0)) {
+        return BigInteger(0);
+    }
+    
+    // 初值取 10^ceil(len/2) ≥ sqrt(n)，避免从 n 开始的大量迭代
+    BigInteger x = BigInteger(1).scaleByPow10((n.digitCount() + 1) / 2);
+    BigInteger y = (x + n / x).half();
+    
+    // 牛顿迭代法求平方根
+    while (y < x) {
+        x = y;
+        y = (x + n / x).half();
+    }
+    
+    return x;
+}
+
+// 辅助函数：阶乘计算
+BigInteger factorial(int n) {
+    BigInteger result(1);
+    for (int i = 2; i <= n; ++i) {
+        result = result * BigInteger(i);
+    }
+    return result;
+}
+
+// 使用二项式系数计算阶乘组合
+BigInteger binomialCoefficient(int n, int k) {
+    if (k < 0 || k > n) return BigInteger(0);
+    if (k == 0 || k == n) return BigInteger(1);
+    
+    BigInteger result(1);
+    
+    // 优化：使用较小的k值计算
+    if (k > n - k) k = n - k;
+    
+    for (int i = 0; i < k; ++i) {
+        result = result * BigInteger(n - i);
+        result = result / BigInteger(i + 1);
+    }
+    
+    return result;
+}
@@ -1,16 +1,456 @@
 #include "BigInteger.h"
 #include <cmath>
 #include <cctype>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
 
-// 构造函数
-BigInteger::BigInteger() : negative(false) {
-    digits.push_back(0);
+namespace {
+
+std::atomic<long long> liveBytes{0}, overallPeak{0}, intervalPeak{0};
+
+void updateMax(std::atomic<long long>& target, long long value) {
+    long long seen = target.load(std::memory_order_relaxed);
+    while (value > seen && !target.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+enum CounterField { CALLS, OPERAND_DIGITS, ALLOCATIONS, ALLOCATED_BYTES, FIELD_COUNT };
+const int TIER_COUNT = (int)OpTier::Count;
+
+// 单个线程的计数器：只有所属线程写入，汇总时由其他线程读取
+struct ThreadCounters {
+    std::atomic<unsigned long long> values[TIER_COUNT][FIELD_COUNT] = {};
+    OpTier tier = OpTier::Other;
+    long long pendingBytes = 0; // 尚未并入 liveBytes 的增量
+
+    void add(OpTier t, CounterField field, unsigned long long n) {
+        std::atomic<unsigned long long>& value = values[(int)t][field];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+// 所有存活线程的计数器，以及已退出线程并入的合计。有意不析构，静态对象析构时仍可能释放数字存储
+struct CounterRegistry {
+    std::mutex mutex;
+    std::vector<ThreadCounters*> threads;
+    unsigned long long retired[TIER_COUNT][FIELD_COUNT] = {};
+};
+
+CounterRegistry& counterRegistry() {
+    static CounterRegistry* registry = new CounterRegistry;
+    return *registry;
+}
+
+thread_local ThreadCounters* threadCounters = nullptr;
+thread_local bool threadCountersRetired = false;
+
+// 线程退出时把计数并入 retired 并注销
+struct ThreadCountersOwner {
+    ~ThreadCountersOwner() {
+        CounterRegistry& registry = counterRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (int t = 0; t < TIER_COUNT; ++t) {
+            for (int f = 0; f < FIELD_COUNT; ++f) {
+                registry.retired[t][f] += threadCounters->values[t][f].load(std::memory_order_relaxed);
+            }
+        }
+        registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), threadCounters));
+        liveBytes.fetch_add(threadCounters->pendingBytes, std::memory_order_relaxed);
+        delete threadCounters;
+        threadCounters = nullptr;
+        threadCountersRetired = true;
+    }
+};
+
+// 当前线程的计数器，首次使用时注册；线程的 thread_local 对象析构之后返回 nullptr
+ThreadCounters* countersForThread() {
+    if (!threadCounters && !threadCountersRetired) {
+        threadCounters = new ThreadCounters;
+        {
+            CounterRegistry& registry = counterRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.threads.push_back(threadCounters);
+        }
+        static thread_local ThreadCountersOwner owner;
+        (void)owner;
+    }
+    return threadCounters;
+}
+
+// 线程退出后（如静态对象析构时）的分配直接加到合计上
+void addRetired(OpTier tier, CounterField field, unsigned long long n) {
+    CounterRegistry& registry = counterRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired[(int)tier][field] += n;
+}
+
+// 乘法模校验（--verify）：对两个操作数都不少于 PRODUCT_CHECK_MIN_DIGITS 位的乘积做模素数检查
+const size_t PRODUCT_CHECK_MIN_DIGITS = 16;
+bool productCheckEnabled = false;
+std::vector<long long> checkPrimes;
+std::atomic<unsigned long long> productCheckCount{0};
+
+void checkProduct(const BigInteger& product, const BigInteger& a, const BigInteger& b) {
+    for (long long p : checkPrimes) {
+        long long expected = a.modSmall(p) * b.modSmall(p) % p;
+        if (product.modSmall(p) != expected) {
+            throw ProductCheckError("乘法校验失败：模 " + std::to_string(p) + " 余数不一致");
+        }
+    }
+    productCheckCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+OpStats::TierScope::TierScope(OpTier tier, size_t operandDigits) : saved(OpTier::Other) {
+    if (ThreadCounters* counters = countersForThread()) {
+        saved = counters->tier;
+        counters->tier = tier;
+        counters->add(tier, CALLS, 1);
+        counters->add(tier, OPERAND_DIGITS, operandDigits);
+    }
+}
+
+OpStats::TierScope::~TierScope() {
+    if (ThreadCounters* counters = countersForThread()) {
+        counters->tier = saved;
+    }
+}
+
+void OpStats::onAllocate(size_t bytes) {
+    ThreadCounters* counters = countersForThread();
+    if (!counters) {
+        addRetired(OpTier::Other, ALLOCATIONS, 1);
+        addRetired(OpTier::Other, ALLOCATED_BYTES, bytes);
+        liveBytes.fetch_add(bytes, std::memory_order_relaxed);
+        return;
+    }
+    counters->add(counters->tier, ALLOCATIONS, 1);
+    counters->add(counters->tier, ALLOCATED_BYTES, bytes);
+    counters->pendingBytes += bytes;
+    if (counters->pendingBytes >= LIVE_BYTES_BATCH) {
+        long long live = liveBytes.fetch_add(counters->pendingBytes, std::memory_order_relaxed) + counters->pendingBytes;
+        counters->pendingBytes = 0;
+        updateMax(overallPeak, live);
+        updateMax(intervalPeak, live);
+    }
+}
+
+void OpStats::onDeallocate(size_t bytes) {
+    ThreadCounters* counters = countersForThread();
+    if (!counters) {
+        liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        return;
+    }
+    counters->pendingBytes -= bytes;
+    if (counters->pendingBytes <= -LIVE_BYTES_BATCH) {
+        liveBytes.fetch_add(counters->pendingBytes, std::memory_order_relaxed);
+        counters->pendingBytes = 0;
+    }
+}
+
+TierCounts OpStats::total(OpTier tier) {
+    CounterRegistry& registry = counterRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    unsigned long long sums[FIELD_COUNT];
+    for (int f = 0; f < FIELD_COUNT; ++f) {
+        sums[f] = registry.retired[(int)tier][f];
+        for (ThreadCounters* counters : registry.threads) {
+            sums[f] += counters->values[(int)tier][f].load(std::memory_order_relaxed);
+        }
+    }
+    TierCounts counts;
+    counts.calls = sums[CALLS];
+    counts.operandDigits = sums[OPERAND_DIGITS];
+    counts.allocations = sums[ALLOCATIONS];
+    counts.allocatedBytes = sums[ALLOCATED_BYTES];
+    return counts;
+}
+
+long long OpStats::peakBytes() {
+    return overallPeak.load(std::memory_order_relaxed);
+}
+
+long long OpStats::intervalPeakBytes() {
+    return intervalPeak.load(std::memory_order_relaxed);
+}
+
+void OpStats::restartInterval() {
+    intervalPeak.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+int BigInteger::karatsubaThreshold = 48;
+int BigInteger::newtonDivisionThreshold = 200;
+int BigInteger::parallelAddThreshold = 1 << 20;
+unsigned BigInteger::parallelAddThreads = 0;
+
+
+// 乘以 10^k（在低位插入k个0）
+BigInteger BigInteger::shiftedLeft(size_t k) const {
+    if (digits.size() == 1 && digits[0] == 0) {
+        return *this;
+    }
+    BigInteger result = *this;
+    result.digits.insert(result.digits.begin(), k, 0);
+    return result;
+}
+
+// 除以 10^k 并向零截断（去掉低k位）
+BigInteger BigInteger::shiftedRight(size_t k) const {
+    if (k >= digits.size()) {
+        return BigInteger(0);
+    }
+    BigInteger result;
+    result.digits.assign(digits.begin() + k, digits.end());
+    result.negative = negative;
+    result.removeLeadingZeros();
+    return result;
+}
+
+// 取第 [from, to) 位组成的非负数
+BigInteger BigInteger::digitRange(size_t from, size_t to) const {
+    to = std::min(to, digits.size());
+    if (from >= to) {
+        return BigInteger(0);
+    }
+    BigInteger result;
+    result.digits.assign(digits.begin() + from, digits.begin() + to);
+    result.removeLeadingZeros();
+    return result;
+}
+
+// 超大操作数的分块并行加减（a 为较长/绝对值较大者）。
+// 各块先按进位（借位）输入为0计算，记录块的进位输出 generate 以及进位输入为1时
+// 是否会穿过整块 propagate（加法时块内全为9，减法时全为0），即两种进位输入下的输出；
+// 再对块做前缀扫描得到实际进位输入，最后各线程只修正收到进位的块
+template <bool Subtract>
+void BigInteger::addSubtractParallel(const BigInteger& a, const BigInteger& b, BigInteger& result, unsigned threads) {
+    const size_t n = a.digits.size();
+    const size_t chunk = (n + threads - 1) / threads;
+    const size_t chunks = (n + chunk - 1) / chunk;
+    std::vector<char> generate(chunks), propagate(chunks), carryIn(chunks + 1, 0);
+    
+    auto runChunks = [&](const std::function<void(size_t)>& body) {
+        std::vector<std::thread> workers;
+        for (size_t c = 1; c < chunks; ++c) {
+            workers.emplace_back(body, c);
+        }
+        body(0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    };
+    
+    runChunks([&](size_t c) {
+        size_t lo = c * chunk, hi = std::min(n, lo + chunk);
+        size_t overlap = std::min(hi, std::max(lo, b.digits.size()));
+        const int* x = a.digits.data();
+        const int* y = b.digits.data();
+        int* out = result.digits.data();
+        int carry = 0;
+        bool saturated = true; // 块内结果全为9（加）或全为0（减）
+        for (size_t i = lo; i < overlap; ++i) {
+            int v = Subtract ? x[i] - y[i] - carry : x[i] + y[i] + carry;
+            carry = Subtract ? v < 0 : v >= 10;
+            out[i] = Subtract ? v + 10 * carry : v - 10 * carry;
+            saturated &= out[i] == (Subtract ? 0 : 9);
+        }
+        for (size_t i = overlap; i < hi; ++i) {
+            int v = Subtract ? x[i] - carry : x[i] + carry;
+            carry = Subtract ? v < 0 : v >= 10;
+            out[i] = Subtract ? v + 10 * carry : v - 10 * carry;
+            saturated &= out[i] == (Subtract ? 0 : 9);
+        }
+        generate[c] = carry;
+        propagate[c] = saturated;
+    });
+    
+    for (size_t c = 0; c < chunks; ++c) {
+        carryIn[c + 1] = generate[c] | (propagate[c] & carryIn[c]);
+    }
+    
+    runChunks([&](size_t c) {
+        if (!carryIn[c]) {
+            return;
+        }
+        size_t hi = std::min(n, (c + 1) * chunk);
+        int* out = result.digits.data();
+        size_t i = c * chunk;
+        for (; i < hi && out[i] == (Subtract ? 0 : 9); ++i) {
+            out[i] = Subtract ? 9 : 0;
+        }
+        if (i < hi) {
+            out[i] += Subtract ? -1 : 1;
+        }
+    });
+    
+    if (!Subtract) {
+        result.digits[n] = carryIn[chunks];
+    }
+}
+
+// 并行加减的线程数：未指定时取硬件线程数，只查询一次（该查询是系统调用，不能放在每次加减里）
+unsigned BigInteger::parallelAddThreadCount() {
+    static const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    return parallelAddThreads > 0 ? parallelAddThreads : hardwareThreads;
+}
+
+// |a| + |b|，单遍进位，结果按最终长度一次分配
+BigInteger BigInteger::addMagnitude(const BigInteger& a, const BigInteger& b) {
+    const BigInteger& longer = a.digits.size() >= b.digits.size() ? a : b;
+    const BigInteger& shorter = a.digits.size() >= b.digits.size() ? b : a;
+    
+    BigInteger result;
+    result.digits.resize(longer.digits.size() + 1);
+    unsigned threads = 0;
+    if (longer.digits.size() >= (size_t)parallelAddThreshold && (threads = parallelAddThreadCount()) > 1) {
+        addSubtractParallel<false>(longer, shorter, result, threads);
+        result.removeLeadingZeros();
+        return result;
+    }
+    
+    int carry = 0;
+    size_t i = 0;
+    for (; i < shorter.digits.size(); ++i) {
+        int sum = longer.digits[i] + shorter.digits[i] + carry;
+        carry = sum >= 10;
+        result.digits[i] = carry ? sum - 10 : sum;
+    }
+    for (; i < longer.digits.size(); ++i) {
+        int sum = longer.digits[i] + carry;
+        carry = sum >= 10;
+        result.digits[i] = carry ? sum - 10 : sum;
+    }
+    result.digits[i] = carry;
+    result.removeLeadingZeros();
+    return result;
+}
+
+// |a| - |b|，要求 |a| ≥ |b|
+BigInteger BigInteger::subtractMagnitude(const BigInteger& a, const BigInteger& b) {
+    BigInteger result;
+    result.digits.resize(a.digits.size());
+    unsigned threads = 0;
+    if (a.digits.size() >= (size_t)parallelAddThreshold && (threads = parallelAddThreadCount()) > 1) {
+        addSubtractParallel<true>(a, b, result, threads);
+        result.removeLeadingZeros();
+        return result;
+    }
+    
+    int borrow = 0;
+    size_t i = 0;
+    for (; i < b.digits.size(); ++i) {
+        int diff = a.digits[i] - b.digits[i] - borrow;
+        borrow = diff < 0;
+        result.digits[i] = borrow ? diff + 10 : diff;
+    }
+    for (; i < a.digits.size(); ++i) {
+        int diff = a.digits[i] - borrow;
+        borrow = diff < 0;
+        result.digits[i] = borrow ? diff + 10 : diff;
+    }
+    result.removeLeadingZeros();
+    return result;
+}
+
+// 计算 a ± |b|（bNegative 为 b 参与运算时的符号），加减法统一入口：至多一次绝对值比较，不复制操作数
+BigInteger BigInteger::addSigned(const BigInteger& a, const BigInteger& b, bool bNegative) {
+    if (a.negative == bNegative) {
+        BigInteger result = addMagnitude(a, b);
+        result.negative = a.negative && !result.isZero();
+        return result;
+    }
+    
+    if (compareMagnitude(a, b) >= 0) {
+        BigInteger result = subtractMagnitude(a, b);
+        result.negative = a.negative && !result.isZero();
+        return result;
+    }
+    BigInteger result = subtractMagnitude(b, a);
+    result.negative = bNegative;
+    return result;
+}
+
+// 朴素乘法（忽略符号）
+BigInteger BigInteger::multiplySchoolbook(const BigInteger& a, const BigInteger& b) {
+    OpStats::TierScope tier(OpTier::MulSchoolbook, a.digits.size() + b.digits.size());
+    BigInteger result;
+    result.digits.resize(a.digits.size() + b.digits.size(), 0);
+    
+    for (size_t i = 0; i < a.digits.size(); ++i) {
+        int carry = 0;
+        for (size_t j = 0; j < b.digits.size() || carry; ++j) {
+            long long curr = result.digits[i + j] + carry;
+            if (j < b.digits.size()) {
+                curr += (long long)a.digits[i] * b.digits[j];
+            }
+            
+            result.digits[i + j] = curr % 10;
+            carry = curr / 10;
+        }
+    }
+    
+    result.removeLeadingZeros();
+    return result;
+}
+
+// 按位数在朴素乘法和Karatsuba之间分派（忽略符号）
+BigInteger BigInteger::multiplyMagnitude(const BigInteger& a, const BigInteger& b) {
+    if (std::min(a.digits.size(), b.digits.size()) < (size_t)karatsubaThreshold) {
+        return multiplySchoolbook(a, b);
+    }
+    
+    // Karatsuba: a = a1·10^h + a0, b = b1·10^h + b0
+    OpStats::TierScope tier(OpTier::MulKaratsuba, a.digits.size() + b.digits.size());
+    size_t h = std::max(a.digits.size(), b.digits.size()) / 2;
+    BigInteger a0 = a.digitRange(0, h), a1 = a.digitRange(h, a.digits.size());
+    BigInteger b0 = b.digitRange(0, h), b1 = b.digitRange(h, b.digits.size());
+    
+    BigInteger z0 = multiplyMagnitude(a0, b0);
+    BigInteger z2 = multiplyMagnitude(a1, b1);
+    // 子块用完即释放，中间项直接累加进结果而不生成移位副本，降低递归的峰值内存
+    BigInteger sumA = a0 + a1;
+    a0 = a1 = BigInteger();
+    BigInteger sumB = b0 + b1;
+    b0 = b1 = BigInteger();
+    BigInteger z1 = multiplyMagnitude(sumA, sumB);
+    sumA = sumB = BigInteger();
+    
+    BigInteger result;
+    result.digits.assign(a.digits.size() + b.digits.size() + 1, 0);
+    accumulateShifted(result.digits, z0, 0, false);
+    accumulateShifted(result.digits, z2, 2 * h, false);
+    accumulateShifted(result.digits, z1, h, false);
+    accumulateShifted(result.digits, z0, h, true);
+    accumulateShifted(result.digits, z2, h, true);
+    result.removeLeadingZeros();
+    return result;
+}
+
+// out += x·10^offset（subtract 时为减），原地处理进位/借位；调用方保证 out 足够长且结果非负
+void BigInteger::accumulateShifted(std::vector<int, CountingAllocator<int>>& out, const BigInteger& x, size_t offset, bool subtract) {
+    int carry = 0;
+    size_t i = 0;
+    for (; i < x.digits.size(); ++i) {
+        int v = subtract ? out[offset + i] - x.digits[i] - carry : out[offset + i] + x.digits[i] + carry;
+        carry = subtract ? v < 0 : v >= 10;
+        out[offset + i] = subtract ? v + 10 * carry : v - 10 * carry;
+    }
+    for (size_t j = offset + i; carry && j < out.size(); ++j) {
+        int v = subtract ? out[j] - 1 : out[j] + 1;
+        carry = subtract ? v < 0 : v >= 10;
+        out[j] = subtract ? v + 10 * carry : v - 10 * carry;
+    }
 }
 
 BigInteger::BigInteger(long long num) {
     negative = (num < 0);
     num = std::abs(num);
-
+    
     if (num == 0) {
         digits.push_back(0);
     } else {
@@ -24,23 +464,23 @@ BigInteger::BigInteger(long long num) {
 BigInteger::BigInteger(const std::string& str) {
     negative = false;
     digits.clear();
-
+    
     int start = 0;
     if (str[0] == '-') {
         negative = true;
         start = 1;
     }
-
+    
     for (int i = str.length() - 1; i >= start; --i) {
         if (std::isdigit(str[i])) {
             digits.push_back(str[i] - '0');
         }
     }
-
+    
     if (digits.empty()) {
         digits.push_back(0);
     }
-
+    
     removeLeadingZeros();
 }
 
@@ -49,7 +489,7 @@ void BigInteger::removeLeadingZeros() {
     while (digits.size() > 1 && digits.back() == 0) {
         digits.pop_back();
     }
-
+    
     if (digits.size() == 1 && digits[0] == 0) {
         negative = false;
     }
@@ -61,147 +501,221 @@ std::string BigInteger::toString() const {
     if (negative && !(digits.size() == 1 && digits[0] == 0)) {
         result += "-";
     }
-
+    
     for (int i = digits.size() - 1; i >= 0; --i) {
         result += std::to_string(digits[i]);
     }
+    
+    return result;
+}
 
+// 乘法
+BigInteger BigInteger::operator*(const BigInteger& other) const {
+    if (digits.size() == 1 && digits[0] == 0 || other.digits.size() == 1 && other.digits[0] == 0) {
+        return BigInteger(0);
+    }
+    
+    BigInteger result = multiplyMagnitude(*this, other);
+    
+    result.negative = negative != other.negative;
+    result.removeLeadingZeros();
+    
+    if (productCheckEnabled && digits.size() >= PRODUCT_CHECK_MIN_DIGITS
+            && other.digits.size() >= PRODUCT_CHECK_MIN_DIGITS) {
+        checkProduct(result, *this, other);
+    }
     return result;
 }
 
-// 加法
-BigInteger BigInteger::operator+(const BigInteger& other) const {
-    if (negative != other.negative) {
-        if (negative) {
-            BigInteger temp = *this;
-            temp.negative = false;
-            return other - temp;
-        } else {
-            BigInteger temp = other;
-            temp.negative = false;
-            return *this - temp;
+// 比较绝对值，返回 -1/0/1，单遍
+int BigInteger::compareMagnitude(const BigInteger& a, const BigInteger& b) {
+    if (a.digits.size() != b.digits.size()) {
+        return a.digits.size() < b.digits.size() ? -1 : 1;
+    }
+    for (int i = a.digits.size() - 1; i >= 0; --i) {
+        if (a.digits[i] != b.digits[i]) {
+            return a.digits[i] < b.digits[i] ? -1 : 1;
         }
     }
+    return 0;
+}
 
-    BigInteger result;
-    result.digits.clear();
-
-    int carry = 0;
-    size_t maxSize = std::max(digits.size(), other.digits.size());
-
-    for (size_t i = 0; i < maxSize || carry; ++i) {
-        int sum = carry;
-        if (i < digits.size()) sum += digits[i];
-        if (i < other.digits.size()) sum += other.digits[i];
-
-        result.digits.push_back(sum % 10);
-        carry = sum / 10;
+// 三路比较，返回 -1/0/1；零总是非负，所以符号不同即可判定
+int BigInteger::compare(const BigInteger& other) const {
+    if (negative != other.negative) {
+        return negative ? -1 : 1;
     }
-
-    result.negative = negative;
-    result.removeLeadingZeros();
-    return result;
+    int magnitude = compareMagnitude(*this, other);
+    return negative ? -magnitude : magnitude;
 }
 
-// 减法
-BigInteger BigInteger::operator-(const BigInteger& other) const {
+bool BigInteger::operator==(const BigInteger& other) const {
     if (negative != other.negative) {
-        BigInteger temp = other;
-        temp.negative = !temp.negative;
-        return *this + temp;
+        return false;
     }
-
-    if (negative) {
-        BigInteger a = *this;
-        BigInteger b = other;
-        a.negative = false;
-        b.negative = false;
-        return b - a;
+    
+    if (digits.size() != other.digits.size()) {
+        return false;
     }
-
-    if (*this < other) {
-        BigInteger result = other - *this;
-        result.negative = true;
-        return result;
+    
+    for (size_t i = 0; i < digits.size(); ++i) {
+        if (digits[i] != other.digits[i]) {
+            return false;
+        }
     }
+    
+    return true;
+}
 
+// 乘以小整数（0 ≤ factor < 2^31），单遍线性
+BigInteger BigInteger::multiplySmall(long long factor) const {
     BigInteger result;
-    result.digits.clear();
-
-    int borrow = 0;
-
+    result.digits.resize(digits.size());
+    long long carry = 0;
     for (size_t i = 0; i < digits.size(); ++i) {
-        int diff = digits[i] - borrow;
-        if (i < other.digits.size()) diff -= other.digits[i];
-
-        if (diff < 0) {
-            diff += 10;
-            borrow = 1;
-        } else {
-            borrow = 0;
-        }
-
-        result.digits.push_back(diff);
+        long long curr = digits[i] * factor + carry;
+        result.digits[i] = curr % 10;
+        carry = curr / 10;
     }
-
+    while (carry > 0) {
+        result.digits.push_back(carry % 10);
+        carry /= 10;
+    }
+    result.negative = negative;
     result.removeLeadingZeros();
     return result;
 }
 
-// 乘法
-BigInteger BigInteger::operator*(const BigInteger& other) const {
-    if (digits.size() == 1 && digits[0] == 0 || other.digits.size() == 1 && other.digits[0] == 0) {
-        return BigInteger(0);
+// 除以小整数（0 < divisor < 2^31），向零截断，单遍线性；remainder 与被除数同号
+BigInteger BigInteger::divideSmall(long long divisor, long long* remainder) const {
+    BigInteger quotient;
+    quotient.digits.resize(digits.size(), 0);
+    long long rem = 0;
+    for (int i = digits.size() - 1; i >= 0; --i) {
+        rem = rem * 10 + digits[i];
+        quotient.digits[i] = rem / divisor;
+        rem %= divisor;
     }
+    quotient.negative = negative;
+    quotient.removeLeadingZeros();
+    if (remainder) {
+        *remainder = negative ? -rem : rem;
+    }
+    return quotient;
+}
 
-    BigInteger result;
-    result.digits.resize(digits.size() + other.digits.size(), 0);
-
-    for (size_t i = 0; i < digits.size(); ++i) {
-        int carry = 0;
-        for (size_t j = 0; j < other.digits.size() || carry; ++j) {
-            long long curr = result.digits[i + j] + carry;
-            if (j < other.digits.size()) {
-                curr += (long long)digits[i] * other.digits[j];
-            }
+// 二进制序列化：1字节符号、8字节小端位数，其后每字节压缩两位十进制数字（低位在低半字节）
+void BigInteger::serialize(std::ostream& out) const {
+    out.put(negative ? 1 : 0);
+    unsigned long long count = digits.size();
+    for (int i = 0; i < 8; ++i) {
+        out.put((char)((count >> (8 * i)) & 0xFF));
+    }
+    for (size_t i = 0; i < digits.size(); i += 2) {
+        int high = i + 1 < digits.size() ? digits[i + 1] : 0;
+        out.put((char)(digits[i] | (high << 4)));
+    }
+}
 
-            result.digits[i + j] = curr % 10;
-            carry = curr / 10;
+BigInteger BigInteger::deserialize(std::istream& in) {
+    BigInteger result;
+    int sign = in.get();
+    unsigned long long count = 0;
+    for (int i = 0; i < 8; ++i) {
+        count |= (unsigned long long)(unsigned char)in.get() << (8 * i);
+    }
+    if (!in || sign > 1 || count == 0 || count > (1ULL << 40)) {
+        throw std::runtime_error("BigInteger 反序列化失败：数据头无效");
+    }
+    
+    result.digits.resize(count);
+    std::string packed((count + 1) / 2, '\0');
+    in.read(&packed[0], packed.size());
+    if (!in) {
+        throw std::runtime_error("BigInteger 反序列化失败：数据不完整");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int digit = ((unsigned char)packed[i / 2] >> (i % 2 ? 4 : 0)) & 0x0F;
+        if (digit > 9) {
+            throw std::runtime_error("BigInteger 反序列化失败：非法数字");
         }
+        result.digits[i] = digit;
     }
-
-    result.negative = negative != other.negative;
+    result.negative = sign == 1;
     result.removeLeadingZeros();
     return result;
 }
 
-// 比较运算符 (<, <=, >, >=)
-bool BigInteger::operator<(const BigInteger& other) const {
-    if (negative != other.negative) {
-        return negative;
-    }
-
-    if (digits.size() != other.digits.size()) {
-        return negative ? digits.size() > other.digits.size() : digits.size() < other.digits.size();
+// 对小素数取模（p < 2^31），用于乘法校验
+long long BigInteger::modSmall(long long p) const {
+    long long r = 0;
+    for (int i = digits.size() - 1; i >= 0; --i) {
+        r = (r * 10 + digits[i]) % p;
     }
+    return r;
+}
 
-    for (int i = digits.size() - 1; i >= 0; --i) {
-        if (digits[i] != other.digits[i]) {
-            return negative ? digits[i] > other.digits[i] : digits[i] < other.digits[i];
+// 开启乘法模校验，随机选取 primeCount 个 [2^30, 2^31) 内的素数
+void BigInteger::enableProductCheck(int primeCount) {
+    std::mt19937_64 rng(std::random_device{}());
+    std::uniform_int_distribution<long long> dist(1LL << 30, (1LL << 31) - 1);
+    
+    checkPrimes.clear();
+    while ((int)checkPrimes.size() < primeCount) {
+        long long candidate = dist(rng) | 1;
+        bool prime = true;
+        for (long long f = 3; f * f <= candidate; f += 2) {
+            if (candidate % f == 0) {
+                prime = false;
+                break;
+            }
+        }
+        if (prime) {
+            checkPrimes.push_back(candidate);
         }
     }
-
-    return false;
+    
+    productCheckEnabled = true;
 }
 
-bool BigInteger::operator<=(const BigInteger& other) const {
-    return *this < other || *this == other;
+unsigned long long BigInteger::productChecks() {
+    return productCheckCount.load();
 }
 
-bool BigInteger::operator>(const BigInteger& other) const {
-    return !(*this <= other);
+// 从调优文件读取阈值（每行 key=value），文件不存在时返回false
+bool BigInteger::loadTuning(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t eq = line.find('=');
+        if (eq == std::string::npos || line[0] == '#') {
+            continue;
+        }
+        std::string key = line.substr(0, eq);
+        int value = std::atoi(line.c_str() + eq + 1);
+        if (key == "karatsuba_threshold") {
+            setKaratsubaThreshold(value);
+        } else if (key == "newton_division_threshold") {
+            setNewtonDivisionThreshold(value);
+        } else if (key == "parallel_add_threshold") {
+            setParallelAddThreshold(value);
+        }
+    }
+    return true;
 }
 
-bool BigInteger::operator>=(const BigInteger& other) const {
-    return !(*this < other);
-}
\ No newline at end of file
+bool BigInteger::saveTuning(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << "# BigInteger 调优文件，由 --tune 生成\n";
+    file << "karatsuba_threshold=" << karatsubaThreshold << "\n";
+    file << "newton_division_threshold=" << newtonDivisionThreshold << "\n";
+    file << "parallel_add_threshold=" << parallelAddThreshold << "\n";
+    return true;
+}
@@ -6,362 +6,307 @@
 #include <iomanip>
 #include <fstream>
 #include <chrono>
+#include <random>
+#include <stdexcept>
+#include <functional>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <future>
+#include <initializer_list>
 
-// 自定义大整数类
-class BigInteger {
-private:
-    std::vector<int> digits; // 按位存储，低位在前
-    bool negative;           // 符号位
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 
-public:
-    // 构造函数
-    BigInteger() : negative(false) {
-        digits.push_back(0);
+#include "BigInteger.h"
+
+// 定点计算时额外保留的位数，吸收每项截断带来的误差
+const int GUARD_DIGITS = 10;
+
+// Chudnovsky / Ramanujan 公式的常数，编译期求值，各驱动和级数定义共用
+constexpr long long CHUDNOVSKY_A = 13591409;
+constexpr long long CHUDNOVSKY_B = 545140134;
+constexpr long long CHUDNOVSKY_C = 640320;
+constexpr long long CHUDNOVSKY_C3 = CHUDNOVSKY_C * CHUDNOVSKY_C * CHUDNOVSKY_C;
+constexpr long long C3_OVER_24 = CHUDNOVSKY_C3 / 24;
+constexpr long long RAMANUJAN_396_4 = 396LL * 396 * 396 * 396;
+static_assert(C3_OVER_24 == 10939058860032000LL, "C^3/24");
+
+// 运行统计（--stats）：BigInteger 库的各档算法计数与内存峰值，加上各阶段的耗时和阶段内内存峰值，以JSON输出
+struct PhaseRecord {
+    std::string name;
+    double seconds;
+    long long peakBytes;
+};
+
+struct Stats {
+    static std::vector<PhaseRecord> phases;
+    static std::string currentPhase;
+    static std::mutex phaseMutex;
+    static std::chrono::high_resolution_clock::time_point phaseStart;
+
+    // 开始新阶段（自动结束上一阶段）；流式计算时阶段记录可能来自后台线程，故加锁
+    static void beginPhase(const std::string& name) {
+        std::lock_guard<std::mutex> lock(phaseMutex);
+        endPhaseLocked();
+        currentPhase = name;
+        phaseStart = std::chrono::high_resolution_clock::now();
+        OpStats::restartInterval();
     }
 
-    BigInteger(long long num) {
-        negative = (num < 0);
-        num = std::abs(num);
-        
-        if (num == 0) {
-            digits.push_back(0);
-        } else {
-            while (num > 0) {
-                digits.push_back(num % 10);
-                num /= 10;
-            }
-        }
+    static void endPhase() {
+        std::lock_guard<std::mutex> lock(phaseMutex);
+        endPhaseLocked();
     }
 
-    BigInteger(const std::string& str) {
-        negative = false;
-        digits.clear();
-        
-        int start = 0;
-        if (str[0] == '-') {
-            negative = true;
-            start = 1;
-        }
-        
-        for (int i = str.length() - 1; i >= start; --i) {
-            if (std::isdigit(str[i])) {
-                digits.push_back(str[i] - '0');
-            }
+    static void endPhaseLocked() {
+        if (currentPhase.empty()) {
+            return;
         }
-        
-        if (digits.empty()) {
-            digits.push_back(0);
-        }
-        
-        removeLeadingZeros();
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - phaseStart;
+        phases.push_back({ currentPhase, elapsed.count(), OpStats::intervalPeakBytes() });
+        currentPhase.clear();
     }
 
-    // 去除前导零
-    void removeLeadingZeros() {
-        while (digits.size() > 1 && digits.back() == 0) {
-            digits.pop_back();
-        }
-        
-        if (digits.size() == 1 && digits[0] == 0) {
-            negative = false;
-        }
+    static void writeTier(std::ostream& out, const char* name, OpTier tier) {
+        TierCounts counts = OpStats::total(tier);
+        out << "\"" << name << "\": {\"calls\": " << counts.calls << ", \"operand_digits\": " << counts.operandDigits
+            << ", \"allocations\": " << counts.allocations << ", \"allocated_bytes\": " << counts.allocatedBytes << "}";
     }
 
-    // 转换为字符串
-    std::string toString() const {
-        std::string result = "";
-        if (negative && !(digits.size() == 1 && digits[0] == 0)) {
-            result += "-";
+    static void writeJson(std::ostream& out, const std::string& algorithm, int digits) {
+        endPhase();
+        TierCounts all;
+        for (int tier = 0; tier < (int)OpTier::Count; ++tier) {
+            TierCounts counts = OpStats::total((OpTier)tier);
+            all.allocations += counts.allocations;
+            all.allocatedBytes += counts.allocatedBytes;
         }
-        
-        for (int i = digits.size() - 1; i >= 0; --i) {
-            result += std::to_string(digits[i]);
+        out << "{\n";
+        out << "  \"algorithm\": \"" << algorithm << "\",\n";
+        out << "  \"digits\": " << digits << ",\n";
+        out << "  \"multiply\": {";
+        writeTier(out, "schoolbook", OpTier::MulSchoolbook);
+        out << ", ";
+        writeTier(out, "karatsuba", OpTier::MulKaratsuba);
+        out << "},\n";
+        out << "  \"divide\": {";
+        writeTier(out, "short", OpTier::DivShort);
+        out << ", ";
+        writeTier(out, "schoolbook", OpTier::DivSchoolbook);
+        out << ", ";
+        writeTier(out, "newton", OpTier::DivNewton);
+        out << "},\n";
+        TierCounts other = OpStats::total(OpTier::Other);
+        out << "  \"allocations\": {\"count\": " << all.allocations << ", \"bytes\": " << all.allocatedBytes
+            << ", \"outside_tiers\": {\"count\": " << other.allocations << ", \"bytes\": " << other.allocatedBytes << "}},\n";
+        out << "  \"peak_bytes\": " << OpStats::peakBytes() << ",\n";
+        out << "  \"phases\": [";
+        for (size_t i = 0; i < phases.size(); ++i) {
+            out << (i ? ", " : "") << "{\"name\": \"" << phases[i].name << "\", \"seconds\": "
+                << std::setprecision(6) << phases[i].seconds << ", \"peak_bytes\": " << phases[i].peakBytes << "}";
         }
-        
-        return result;
+        out << "]\n}\n";
     }
+};
 
-    // 加法
-    BigInteger operator+(const BigInteger& other) const {
-        if (negative != other.negative) {
-            if (negative) {
-                BigInteger temp = *this;
-                temp.negative = false;
-                return other - temp;
-            } else {
-                BigInteger temp = other;
-                temp.negative = false;
-                return *this - temp;
-            }
+std::vector<PhaseRecord> Stats::phases;
+std::string Stats::currentPhase;
+std::mutex Stats::phaseMutex;
+std::chrono::high_resolution_clock::time_point Stats::phaseStart;
+
+// 进度报告：计算线程只累加加权工作量，由独立线程按时间节流输出进度和预计剩余时间。
+// 标准输出不是终端时不启动线程，advance 只剩一次原子加法。
+// 中途无法报告的长步骤（如开方）用 beginStep/endStep 包住，报告线程按此前的速率在该步工作量内外推
+class ProgressReporter {
+private:
+    static bool enabled;
+
+    std::string label;
+    unsigned long long totalWork;
+    std::atomic<unsigned long long> doneWork{0};
+    std::chrono::steady_clock::time_point startTime;
+    unsigned long long stepWork = 0; // 进行中步骤的工作量，受 mutex 保护
+    std::chrono::steady_clock::time_point stepStart;
+    
+    std::thread reporter;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopped = false;
+    bool printed = false;
+
+    void print(std::chrono::steady_clock::time_point now) {
+        double done = (double)doneWork.load(std::memory_order_relaxed);
+        std::chrono::duration<double> elapsed = now - startTime;
+        std::chrono::duration<double> beforeStep = stepStart - startTime;
+        if (stepWork > 0 && done > 0 && beforeStep.count() > 0) {
+            std::chrono::duration<double> inStep = now - stepStart;
+            done += std::min((double)stepWork, done / beforeStep.count() * inStep.count());
         }
+        double fraction = std::min(1.0, done / totalWork);
         
-        BigInteger result;
-        result.digits.clear();
-        
-        int carry = 0;
-        size_t maxSize = std::max(digits.size(), other.digits.size());
-        
-        for (size_t i = 0; i < maxSize || carry; ++i) {
-            int sum = carry;
-            if (i < digits.size()) sum += digits[i];
-            if (i < other.digits.size()) sum += other.digits[i];
-            
-            result.digits.push_back(sum % 10);
-            carry = sum / 10;
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << "\r" << label << " 已完成 " << 100.0 * fraction
+             << "%，已用 " << elapsed.count() << " 秒";
+        if (fraction > 0 && fraction < 1) {
+            line << "，预计剩余 " << elapsed.count() * (1 - fraction) / fraction << " 秒";
         }
-        
-        result.negative = negative;
-        result.removeLeadingZeros();
-        return result;
+        line << "    ";
+        std::cout << line.str() << std::flush;
+        printed = true;
     }
 
-    // 减法
-    BigInteger operator-(const BigInteger& other) const {
-        if (negative != other.negative) {
-            BigInteger temp = other;
-            temp.negative = !temp.negative;
-            return *this + temp;
-        }
-        
-        if (negative) {
-            BigInteger a = *this;
-            BigInteger b = other;
-            a.negative = false;
-            b.negative = false;
-            return b - a;
-        }
-        
-        if (*this < other) {
-            BigInteger result = other - *this;
-            result.negative = true;
-            return result;
-        }
-        
-        BigInteger result;
-        result.digits.clear();
+    void run() {
+        const auto REPORT_INTERVAL = std::chrono::seconds(1);
+        auto lastPrint = startTime;
         
-        int borrow = 0;
-        
-        for (size_t i = 0; i < digits.size(); ++i) {
-            int diff = digits[i] - borrow;
-            if (i < other.digits.size()) diff -= other.digits[i];
-            
-            if (diff < 0) {
-                diff += 10;
-                borrow = 1;
-            } else {
-                borrow = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopped) {
+            wakeup.wait_for(lock, std::chrono::milliseconds(100));
+            auto now = std::chrono::steady_clock::now();
+            if (!stopped && now - lastPrint >= REPORT_INTERVAL) {
+                print(now);
+                lastPrint = now;
             }
-            
-            result.digits.push_back(diff);
         }
-        
-        result.removeLeadingZeros();
-        return result;
     }
 
-    // 乘法
-    BigInteger operator*(const BigInteger& other) const {
-        if (digits.size() == 1 && digits[0] == 0 || other.digits.size() == 1 && other.digits[0] == 0) {
-            return BigInteger(0);
-        }
-        
-        BigInteger result;
-        result.digits.resize(digits.size() + other.digits.size(), 0);
-        
-        for (size_t i = 0; i < digits.size(); ++i) {
-            int carry = 0;
-            for (size_t j = 0; j < other.digits.size() || carry; ++j) {
-                long long curr = result.digits[i + j] + carry;
-                if (j < other.digits.size()) {
-                    curr += (long long)digits[i] * other.digits[j];
-                }
-                
-                result.digits[i + j] = curr % 10;
-                carry = curr / 10;
-            }
+public:
+    // totalWork 为按算法代价模型估计的总工作量，与 advance 的单位一致
+    ProgressReporter(const std::string& label, unsigned long long totalWork)
+        : label(label), totalWork(std::max(totalWork, 1ULL)), startTime(std::chrono::steady_clock::now()) {
+        if (enabled && isatty(fileno(stdout))) {
+            reporter = std::thread(&ProgressReporter::run, this);
         }
-        
-        result.negative = negative != other.negative;
-        result.removeLeadingZeros();
-        return result;
     }
 
-    // 除法
-    std::pair<BigInteger, BigInteger> divmod(const BigInteger& divisor) const {
-        if (divisor.digits.size() == 1 && divisor.digits[0] == 0) {
-            throw std::runtime_error("Division by zero");
-        }
-        
-        if (*this < divisor) {
-            return { BigInteger(0), *this };
-        }
-        
-        BigInteger a = *this;
-        BigInteger b = divisor;
-        a.negative = false;
-        b.negative = false;
-        
-        BigInteger quotient;
-        BigInteger remainder;
-        
-        quotient.digits.resize(a.digits.size(), 0);
-        
-        for (int i = a.digits.size() - 1; i >= 0; --i) {
-            remainder.digits.insert(remainder.digits.begin(), a.digits[i]);
-            remainder.removeLeadingZeros();
-            
-            int q = 0;
-            int l = 0, r = 9;
-            while (l <= r) {
-                int mid = (l + r) / 2;
-                BigInteger temp = b * BigInteger(mid);
-                if (temp <= remainder) {
-                    q = mid;
-                    l = mid + 1;
-                } else {
-                    r = mid - 1;
-                }
-            }
-            
-            quotient.digits[i] = q;
-            remainder = remainder - b * BigInteger(q);
-        }
-        
-        quotient.removeLeadingZeros();
-        quotient.negative = negative != divisor.negative;
-        remainder.negative = negative;
-        
-        return { quotient, remainder };
+    ~ProgressReporter() {
+        finish();
+    }
+
+    void advance(unsigned long long work) {
+        doneWork.fetch_add(work, std::memory_order_relaxed);
     }
 
-    BigInteger operator/(const BigInteger& other) const {
-        return divmod(other).first;
+    void beginStep(unsigned long long work) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stepWork = work;
+        stepStart = std::chrono::steady_clock::now();
     }
 
-    BigInteger operator%(const BigInteger& other) const {
-        return divmod(other).second;
+    // 结束当前步骤并计入其全部工作量
+    void endStep() {
+        std::lock_guard<std::mutex> lock(mutex);
+        doneWork.fetch_add(stepWork, std::memory_order_relaxed);
+        stepWork = 0;
     }
 
-    // 比较运算符
-    bool operator<(const BigInteger& other) const {
-        if (negative != other.negative) {
-            return negative;
+    // 停止报告线程；若已输出过进度则补一行100%
+    void finish() {
+        if (!reporter.joinable()) {
+            return;
         }
-        
-        if (digits.size() != other.digits.size()) {
-            return negative ? digits.size() > other.digits.size() : digits.size() < other.digits.size();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
         }
-        
-        for (int i = digits.size() - 1; i >= 0; --i) {
-            if (digits[i] != other.digits[i]) {
-                return negative ? digits[i] > other.digits[i] : digits[i] < other.digits[i];
-            }
+        wakeup.notify_one();
+        reporter.join();
+        if (printed) {
+            doneWork.store(totalWork);
+            print(std::chrono::steady_clock::now());
+            std::cout << "\n";
         }
-        
-        return false;
     }
 
-    bool operator<=(const BigInteger& other) const {
-        return *this < other || *this == other;
+    static void setEnabled(bool value) {
+        enabled = value;
     }
+};
 
-    bool operator>(const BigInteger& other) const {
-        return !(*this <= other);
-    }
+bool ProgressReporter::enabled = true;
 
-    bool operator>=(const BigInteger& other) const {
-        return !(*this < other);
-    }
+// ---------------- 结果校验（--verify） ----------------
 
-    bool operator==(const BigInteger& other) const {
-        if (negative != other.negative) {
-            return false;
-        }
-        
-        if (digits.size() != other.digits.size()) {
-            return false;
+// 16^e mod m（m < 2^31）
+long long powMod16(long long e, long long m) {
+    long long result = 1 % m, base = 16 % m;
+    for (; e > 0; e >>= 1) {
+        if (e & 1) {
+            result = result * base % m;
         }
-        
-        for (size_t i = 0; i < digits.size(); ++i) {
-            if (digits[i] != other.digits[i]) {
-                return false;
-            }
-        }
-        
-        return true;
+        base = base * base % m;
     }
+    return result;
+}
 
-    bool operator!=(const BigInteger& other) const {
-        return !(*this == other);
+// BBP公式的 {Σ_{i≥0} 16^(k-i)/(8i+j)}：i ≤ k 的部分用模幂只保留小数部分，其余为收敛很快的尾项
+long double bbpSeries(int j, long long k) {
+    long double sum = 0;
+    for (long long i = 0; i <= k; ++i) {
+        long long m = 8 * i + j;
+        sum += (long double)powMod16(k - i, m) / m;
+        sum -= std::floor(sum);
     }
-
-    // 求幂
-    BigInteger pow(int exponent) const {
-        if (exponent < 0) {
-            throw std::runtime_error("Negative exponent not supported");
-        }
-        
-        if (exponent == 0) {
-            return BigInteger(1);
-        }
-        
-        if (exponent == 1) {
-            return *this;
-        }
-        
-        if (exponent % 2 == 0) {
-            BigInteger half = pow(exponent / 2);
-            return half * half;
-        } else {
-            return *this * pow(exponent - 1);
+    long double power = 1;
+    for (long long i = k + 1; ; ++i) {
+        power /= 16;
+        long double term = power / (8 * i + j);
+        if (term < 1e-20L) {
+            break;
         }
+        sum += term;
     }
-};
+    return sum - std::floor(sum);
+}
 
-// 定义平方根函数（使用牛顿迭代法）
-BigInteger sqrt(const BigInteger& n) {
-    if (n <= BigInteger(0)) {
-        return BigInteger(0);
-    }
-    
-    BigInteger x = n;
-    BigInteger y = (x + n / x) / BigInteger(2);
-    
-    // 牛顿迭代法求平方根
-    while (y < x) {
-        x = y;
-        y = (x + n / x) / BigInteger(2);
-    }
-    
-    return x;
+// BBP公式：{16^k·π} = {4·S(1) - 2·S(4) - S(5) - S(6)}
+long double bbpPiFraction(long long k) {
+    long double fraction = 4 * bbpSeries(1, k) - 2 * bbpSeries(4, k) - bbpSeries(5, k) - bbpSeries(6, k);
+    return fraction - std::floor(fraction);
 }
 
-// 辅助函数：阶乘计算
-BigInteger factorial(int n) {
-    BigInteger result(1);
-    for (int i = 2; i <= n; ++i) {
-        result = result * BigInteger(i);
-    }
-    return result;
+// 十进制小数部分 F（digits位，截断）在十六进制第 k+1 位起的值 {16^k·F} 与BBP结果的模1距离是否落在截断窗口内：
+// 真值在 [g, g + 16^k/10^digits) 中
+bool matchesBbp(long double actual, long long k, int digits) {
+    const long double TOLERANCE = 1e-9L; // BBP 累加的舍入误差上界
+    long double window = std::exp(k * std::log(16.0L) - digits * std::log(10.0L));
+    long double distance = bbpPiFraction(k) - actual;
+    distance -= std::floor(distance);
+    return distance < window + TOLERANCE || distance > 1 - TOLERANCE;
 }
 
-// 使用二项式系数计算阶乘组合
-BigInteger binomialCoefficient(int n, int k) {
-    if (k < 0 || k > n) return BigInteger(0);
-    if (k == 0 || k == n) return BigInteger(1);
-    
-    BigInteger result(1);
-    
-    // 优化：使用较小的k值计算
-    if (k > n - k) k = n - k;
+// 用与各驱动都独立的BBP公式校验π的十进制结果，代价约为一次结果规模的乘法。
+// 尾部：k 取使截断窗口约为 10^-6 的最大值，由 fraction·16^k 模 10^digits 换算出 {16^k·F}，
+// 任何一位（含最后一位）出错都会移出窗口；只有小数第1位差5时 5·16^k/10 恰为整数、模1不变，
+// 因此再在 k=0 处核对开头的数字
+bool verifyPiTail(const std::string& pi, int digits, long long& hexPosition) {
+    const int FRACTION_DIGITS = 18;
+    long long k = std::max(0LL, (long long)((digits - 6) * std::log(10.0) / std::log(16.0)));
+    hexPosition = k + 1;
+    if (pi.compare(0, 2, "3.") != 0) {
+        return false;
+    }
     
-    for (int i = 0; i < k; ++i) {
-        result = result * BigInteger(n - i);
-        result = result / BigInteger(i + 1);
+    std::string head = pi.substr(2, FRACTION_DIGITS);
+    if (!matchesBbp(std::stold(head) / std::pow(10.0L, head.size()), 0, head.size())) {
+        return false;
     }
     
-    return result;
+    BigInteger fraction(pi.substr(2));
+    BigInteger shifted = fraction * BigInteger(16).pow((int)k);
+    BigInteger low = shifted - shifted.scaleByPow10(-digits).scaleByPow10(digits);
+    long double actual = std::stold(low.scaleByPow10(FRACTION_DIGITS - digits).toString()) / std::pow(10.0L, FRACTION_DIGITS);
+    return matchesBbp(actual, k, digits);
 }
 
 // Chudnovsky算法计算π
@@ -373,20 +318,41 @@ std::string calculatePi(int digits) {
     int terms = (int)(digits / 14.1) + 5; // 每项约产生14位，额外加5项以确保精度
     std::cout << "使用Chudnovsky算法，计算" << terms << "项..." << std::endl;
     
-    const BigInteger C = BigInteger(640320);
-    const BigInteger C3_OVER_24 = (C * C * C) / BigInteger(24);
+    // 定点数：所有项都乘以 10^SCALE 后再做整数除法
+    const int SCALE = digits + GUARD_DIGITS;
+    
+    const BigInteger C3 = BigInteger(CHUDNOVSKY_C3);
     
     BigInteger sum(0);
+    // (6k)!、(3k)!、(k!)^3 与 C^3k 随k递推，每项只乘上新增的因子
+    BigInteger factorial6k(1), factorial3k(1), factorialCubed(1), powerC3(1);
+    
+    // 每项的代价由定点除法主导，操作数约为 digits 位加上随k线性增长的分母（每项约28位）
+    auto termWork = [&](int k) { return (unsigned long long)digits + 28ULL * k; };
+    unsigned long long totalWork = 0;
+    for (int k = 0; k < terms; ++k) {
+        totalWork += termWork(k);
+    }
+    ProgressReporter progress("Chudnovsky", totalWork);
     
+    Stats::beginPhase("series");
     for (int k = 0; k < terms; ++k) {
+        if (k > 0) {
+            for (int j = 6 * k - 5; j <= 6 * k; ++j) {
+                factorial6k = factorial6k.multiplySmall(j);
+            }
+            for (int j = 3 * k - 2; j <= 3 * k; ++j) {
+                factorial3k = factorial3k.multiplySmall(j);
+            }
+            factorialCubed = factorialCubed.multiplySmall(k).multiplySmall(k).multiplySmall(k);
+            powerC3 = powerC3 * C3;
+        }
+        
         // 计算Chudnovsky公式的分子
-        BigInteger MK = factorial(6 * k);
-        MK = MK * (BigInteger(545140134) * BigInteger(k) + BigInteger(13591409));
+        BigInteger MK = factorial6k * BigInteger(CHUDNOVSKY_B * k + CHUDNOVSKY_A);
         
         // 计算分母
-        BigInteger NK = factorial(3 * k);
-        NK = NK * factorial(k).pow(3);
-        NK = NK * C3_OVER_24.pow(k);
+        BigInteger NK = factorial3k * factorialCubed * powerC3;
         
         // 根据k的奇偶性确定符号
         if (k % 2 == 1) {
@@ -394,20 +360,20 @@ std::string calculatePi(int digits) {
         }
         
         // 执行除法并累加结果
-        BigInteger term = MK / NK;
+        BigInteger term = MK.scaleByPow10(SCALE) / NK;
         sum = sum + term;
         
-        // 进度报告
-        if (k % 5 == 0 || k == terms - 1) {
-            std::cout << "已完成 " << k + 1 << "/" << terms << " 项 (" 
-                      << std::fixed << std::setprecision(1) << (100.0 * (k + 1) / terms) << "%)" << std::endl;
-        }
+        progress.advance(termWork(k));
     }
+    progress.finish();
     
-    // 应用Chudnovsky公式的常数系数
-    BigInteger sqrtTerm = sqrt(BigInteger(10005));
-    BigInteger numerator = BigInteger(426880) * sqrtTerm;
+    // 应用Chudnovsky公式的常数系数：π = 426880·sqrt(10005) / sum
+    Stats::beginPhase("sqrt");
+    BigInteger sqrtTerm = sqrt(BigInteger(10005).scaleByPow10(2 * SCALE));
+    Stats::beginPhase("division");
+    BigInteger numerator = (BigInteger(426880) * sqrtTerm).scaleByPow10(SCALE);
     BigInteger pi = numerator / sum;
+    Stats::endPhase();
     
     // 计时结束
     auto endTime = std::chrono::high_resolution_clock::now();
@@ -415,7 +381,9 @@ std::string calculatePi(int digits) {
     std::cout << "计算完成！用时 " << elapsed.count() << " 秒" << std::endl;
     
     // 格式化结果
+    Stats::beginPhase("conversion");
     std::string piStr = pi.toString();
+    Stats::endPhase();
     
     // 插入小数点（π的整数部分是3）
     if (piStr.length() > 1) {
@@ -445,39 +413,46 @@ std::string calculatePiOptimized(int digits) {
     std::cout << "计算" << terms << "项..." << std::endl;
     
     // Chudnovsky算法的常数
-    const BigInteger A = BigInteger(13591409);
-    const BigInteger B = BigInteger(545140134);
-    const BigInteger C = BigInteger(640320);
+    const BigInteger A = BigInteger(CHUDNOVSKY_A);
+    const BigInteger B = BigInteger(CHUDNOVSKY_B);
     const BigInteger D = BigInteger(426880);
     const BigInteger E = BigInteger(10005);
-    const BigInteger C3_24 = (C * C * C) / BigInteger(24);
+    const BigInteger C3_24 = BigInteger(C3_OVER_24);
+    const int SCALE = digits + GUARD_DIGITS;
     
+    // 级数和 = sumA / sumB，prodP 为相邻项比值分子的累积乘积
     BigInteger sumA = A;
     BigInteger sumB = BigInteger(1);
+    BigInteger prodP = BigInteger(1);
+    
+    // 部分和的位数随k线性增长，而每步只乘以单精度量，代价按 k 计
+    ProgressReporter progress("Chudnovsky", (unsigned long long)terms * (terms - 1) / 2);
     
-    // 二进制分割法计算Pi
+    Stats::beginPhase("series");
+    // 利用相邻项比值 -(6k-5)(2k-1)(6k-1) / (k^3·C^3/24) 迭代，循环内不做除法
     for (int k = 1; k < terms; ++k) {
         // 迭代计算Chudnovsky公式
-        BigInteger numerator = BigInteger(6 * k - 5) * BigInteger(6 * k - 4) * BigInteger(6 * k - 3);
+        BigInteger numerator = BigInteger(-(6LL * k - 5) * (2LL * k - 1) * (6LL * k - 1));
         BigInteger term_A = A + B * BigInteger(k);
         
         // 计算迭代项
-        BigInteger denominator = BigInteger(k * k * k) * C3_24;
+        BigInteger denominator = BigInteger((long long)k * k * k) * C3_24;
         
-        sumA = sumA * denominator + term_A * sumB * numerator;
+        prodP = prodP * numerator;
+        sumA = sumA * denominator + term_A * prodP;
         sumB = sumB * denominator;
         
-        // 定期显示进度
-        if (k % 10 == 0 || k == terms - 1) {
-            std::cout << "已完成 " << k << "/" << terms << " 项 (" 
-                      << std::fixed << std::setprecision(1) << (100.0 * k / terms) << "%)" << std::endl;
-        }
+        progress.advance(k);
     }
+    progress.finish();
     
-    // 应用最终系数
-    BigInteger sqrtE = sqrt(E);
+    // 应用最终系数：π = D·sqrt(E)·sumB / sumA
+    Stats::beginPhase("sqrt");
+    BigInteger sqrtE = sqrt(E.scaleByPow10(2 * SCALE));
+    Stats::beginPhase("division");
     BigInteger numerator = D * sqrtE * sumB;
     BigInteger pi = numerator / sumA;
+    Stats::endPhase();
     
     // 计时结束
     auto endTime = std::chrono::high_resolution_clock::now();
@@ -485,7 +460,9 @@ std::string calculatePiOptimized(int digits) {
     std::cout << "计算完成！用时 " << elapsed.count() << " 秒" << std::endl;
     
     // 格式化结果
+    Stats::beginPhase("conversion");
     std::string piStr = pi.toString();
+    Stats::endPhase();
     
     // 插入小数点
     if (piStr.length() > 1) {
@@ -513,34 +490,55 @@ std::string calculatePiRamanujan(int digits) {
     int terms = (int)(digits / 8.0) + 2; // Ramanujan公式每项约产生8位
     std::cout << "计算" << terms << "项..." << std::endl;
     
-    const BigInteger FOUR = BigInteger(4);
-    const BigInteger SQRT8 = BigInteger(2) * sqrt(BigInteger(2));
-    const BigInteger NINEONEFOUR = BigInteger(9801);
+    const int SCALE = digits + GUARD_DIGITS;
+    Stats::beginPhase("sqrt");
+    const BigInteger SQRT8 = sqrt(BigInteger(2).scaleByPow10(2 * SCALE)).multiplySmall(2);
+    const BigInteger NINEEIGHTZEROONE = BigInteger(9801);
     
     BigInteger sum(0);
+    // (4k)!、(k!)^4 与 396^4k 随k递推
+    BigInteger factorial4k(1), factorialFourth(1), power396(1);
+    
+    // 代价模型同Chudnovsky，分母每项约增长16位
+    auto termWork = [&](int k) { return (unsigned long long)digits + 16ULL * k; };
+    unsigned long long totalWork = 0;
+    for (int k = 0; k < terms; ++k) {
+        totalWork += termWork(k);
+    }
+    ProgressReporter progress("Ramanujan", totalWork);
     
+    Stats::beginPhase("series");
     for (int k = 0; k < terms; ++k) {
-        BigInteger numerator = factorial(4 * k) * (BigInteger(1103) + BigInteger(26390) * BigInteger(k));
-        BigInteger denominator = factorial(k).pow(4) * BigInteger(396).pow(4 * k);
+        if (k > 0) {
+            for (int j = 4 * k - 3; j <= 4 * k; ++j) {
+                factorial4k = factorial4k.multiplySmall(j);
+            }
+            factorialFourth = factorialFourth.multiplySmall(k).multiplySmall(k).multiplySmall(k).multiplySmall(k);
+            power396 = power396 * BigInteger(RAMANUJAN_396_4);
+        }
+        BigInteger numerator = factorial4k * BigInteger(1103 + 26390LL * k);
+        BigInteger denominator = factorialFourth * power396;
         
-        BigInteger term = numerator / denominator;
+        BigInteger term = numerator.scaleByPow10(SCALE) / denominator;
         sum = sum + term;
         
-        if (k % 5 == 0 || k == terms - 1) {
-            std::cout << "已完成 " << k + 1 << "/" << terms << " 项 (" 
-                      << std::fixed << std::setprecision(1) << (100.0 * (k + 1) / terms) << "%)" << std::endl;
-        }
+        progress.advance(termWork(k));
     }
+    progress.finish();
     
-    // 应用Ramanujan公式的常数系数
-    BigInteger pi = (SQRT8 / NINEONEFOUR) / sum;
+    // 应用Ramanujan公式的常数系数：π = 9801 / (2·sqrt(2)·sum)
+    Stats::beginPhase("division");
+    BigInteger pi = NINEEIGHTZEROONE.scaleByPow10(3 * SCALE) / (SQRT8 * sum);
+    Stats::endPhase();
     
     auto endTime = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = endTime - startTime;
     std::cout << "计算完成！用时 " << elapsed.count() << " 秒" << std::endl;
     
     // 格式化结果
+    Stats::beginPhase("conversion");
     std::string piStr = pi.toString();
+    Stats::endPhase();
     
     // 插入小数点
     if (piStr.length() > 1) {
@@ -558,9 +556,1079 @@ std::string calculatePiRamanujan(int digits) {
     }
 }
 
+// ---------------- 超几何级数常数引擎（-a/--constant） ----------------
+
+// 整系数多项式，系数低次在前
+struct Polynomial {
+    std::vector<long long> coefficients;
+
+    Polynomial(std::initializer_list<long long> c) : coefficients(c) {}
+
+    Polynomial operator*(const Polynomial& other) const {
+        Polynomial result({});
+        result.coefficients.assign(coefficients.size() + other.coefficients.size() - 1, 0);
+        for (size_t i = 0; i < coefficients.size(); ++i) {
+            for (size_t j = 0; j < other.coefficients.size(); ++j) {
+                result.coefficients[i + j] += coefficients[i] * other.coefficients[j];
+            }
+        }
+        return result;
+    }
+
+    Polynomial pow(int exponent) const {
+        Polynomial result({1});
+        for (int i = 0; i < exponent; ++i) {
+            result = result * *this;
+        }
+        return result;
+    }
+
+    // Horner法求值，结果可超出long long
+    BigInteger operator()(long long k) const {
+        BigInteger result(coefficients.back());
+        const BigInteger K(k);
+        for (int i = coefficients.size() - 2; i >= 0; --i) {
+            result = result * K + BigInteger(coefficients[i]);
+        }
+        return result;
+    }
+
+    double evaluate(double k) const {
+        double result = 0;
+        for (int i = coefficients.size() - 1; i >= 0; --i) {
+            result = result * k + coefficients[i];
+        }
+        return result;
+    }
+};
+
+// 有理超几何级数 S = Σ_{k≥0} a(k)/b(k) · Π_{j=1..k} p(j)/q(j)
+struct HypergeometricSeries {
+    Polynomial a, b, p, q;
+};
+
+// 区间 [n1, n2) 的二分法状态：P = Πp, Q = Πq, B = Πb，区间内部分和为 T/(B·Q)
+struct SeriesState {
+    BigInteger P, Q, B, T;
+};
+
+// 进度的工作量单位：d 位乘法按 Karatsuba 的代价 d^1.585 计。一次合并、一次牛顿除法、一次开方迭代
+// 分别折算成若干次操作数规模的乘法，系数由 --stats 的各阶段耗时实测标定
+// （20000位时π的级数、normalize、sqrt 与 ζ(3)、e 的级数换算后速率一致）
+const double MERGE_MULTIPLICATIONS = 6;
+const double DIVISION_MULTIPLICATIONS = 12;
+const double SQRT_ITERATION_MULTIPLICATIONS = 7;
+
+unsigned long long multiplyWork(double digits) {
+    return (unsigned long long)std::pow(std::max(digits, 1.0), 1.585);
+}
+
+unsigned long long mergeWork(double operandDigits) {
+    return (unsigned long long)(MERGE_MULTIPLICATIONS * multiplyWork(operandDigits));
+}
+
+unsigned long long divisionWork(double digits) {
+    return (unsigned long long)(DIVISION_MULTIPLICATIONS * multiplyWork(digits));
+}
+
+// sqrt 从 10^ceil(len/2) 起做全精度牛顿迭代，迭代次数约为结果位数的 log2 加上初值阶段的5次
+unsigned long long sqrtWork(double digits) {
+    double iterations = std::log2(std::max(digits, 2.0)) + 5;
+    return (unsigned long long)(iterations * SQRT_ITERATION_MULTIPLICATIONS * multiplyWork(digits));
+}
+
+// 合并相邻区间 [n1, m) 与 [m, n2)。按值接收，调用方 std::move 进来后每算完一个分量就释放对应输入；
+// needP 为false时不计算 P（最右侧路径上的 P 不会再被用到）
+SeriesState mergeSeriesStates(SeriesState left, SeriesState right, bool needP = true) {
+    SeriesState result;
+    result.T = right.B * right.Q * left.T + left.B * left.P * right.T;
+    left.T = right.T = BigInteger();
+    result.Q = left.Q * right.Q;
+    left.Q = right.Q = BigInteger();
+    result.B = left.B * right.B;
+    left.B = right.B = BigInteger();
+    if (needP) {
+        result.P = left.P * right.P;
+    }
+    return result;
+}
+
+// 二分法求区间 [n1, n2) 的状态，前 parallelDepth 层左右两半并行计算；
+// 深度优先求值，同一时刻只保留当前路径上的左半结果
+SeriesState evaluateSeries(const HypergeometricSeries& series, long long n1, long long n2,
+                           int parallelDepth, ProgressReporter* progress, bool needP = true) {
+    if (n2 - n1 == 1) {
+        SeriesState leaf;
+        // 乘积从 j=1 开始，第0项不含 p/q 因子
+        leaf.P = n1 == 0 ? BigInteger(1) : series.p(n1);
+        leaf.Q = n1 == 0 ? BigInteger(1) : series.q(n1);
+        leaf.B = series.b(n1);
+        leaf.T = series.a(n1) * leaf.P;
+        return leaf;
+    }
+    
+    long long m = (n1 + n2) / 2;
+    SeriesState left, right;
+    if (parallelDepth > 0) {
+        auto future = std::async(std::launch::async, evaluateSeries, std::cref(series), n1, m, parallelDepth - 1, progress, true);
+        right = evaluateSeries(series, m, n2, parallelDepth - 1, progress, needP);
+        left = future.get();
+    } else {
+        left = evaluateSeries(series, n1, m, 0, progress, true);
+        right = evaluateSeries(series, m, n2, 0, progress, needP);
+    }
+    
+    unsigned long long work = mergeWork((left.T.digitCount() + right.T.digitCount()) / 2.0);
+    SeriesState result = mergeSeriesStates(std::move(left), std::move(right), needP);
+    if (progress) {
+        progress->advance(work);
+    }
+    return result;
+}
+
+// 区间 [n1, n2) 的级数状态（Q 及 T）位数估计：每项贡献 max(p, q) 与 b 的位数
+double seriesStateDigits(const HypergeometricSeries& series, long long n1, long long n2) {
+    double stateDigits = 0;
+    for (long long k = std::max(n1, 1LL); k < n2; ++k) {
+        stateDigits += std::max(std::log10(std::fabs(series.p.evaluate(k))), std::log10(std::fabs(series.q.evaluate(k))))
+                       + std::log10(std::fabs(series.b.evaluate(k)));
+    }
+    return stateDigits;
+}
+
+// 二分法各层合并的预计工作量之和，区间的状态位数按平均每项位数估计
+unsigned long long seriesWork(double termDigits, long long n1, long long n2) {
+    if (n2 - n1 <= 1) {
+        return 0;
+    }
+    long long m = (n1 + n2) / 2;
+    return mergeWork((n2 - n1) * termDigits / 2) + seriesWork(termDigits, n1, m) + seriesWork(termDigits, m, n2);
+}
+
+unsigned long long seriesWork(const HypergeometricSeries& series, long long n1, long long n2) {
+    return n2 - n1 > 1 ? seriesWork(std::max(1.0, seriesStateDigits(series, n1, n2) / (n2 - n1)), n1, n2) : 0;
+}
+
+// 按项的量级估算达到指定精度所需的项数
+long long seriesTermsNeeded(const HypergeometricSeries& series, int digits) {
+    const long long MAX_TERMS = 1LL << 40;
+    double logTerm = 0; // log10 Π p(j)/q(j)
+    for (long long k = 0; k < MAX_TERMS; ++k) {
+        if (k > 0) {
+            logTerm += std::log10(std::fabs(series.p.evaluate(k) / series.q.evaluate(k)));
+        }
+        double logA = std::log10(std::fabs(series.a.evaluate(k) / series.b.evaluate(k)) + 1e-300);
+        if (k > 0 && logTerm + logA < -(digits + GUARD_DIGITS)) {
+            return k + 2;
+        }
+    }
+    throw std::runtime_error("级数收敛过慢");
+}
+
+// 级数状态文件（缓存和分片共用）：魔数、区间 [n1, n2) 的两个8字节小端整数，其后依次为 P、Q、B、T
+const char SERIES_STATE_MAGIC[4] = { 'B', 'S', 'P', '2' };
+
+bool saveSeriesState(const std::string& path, long long n1, long long n2, const SeriesState& state) {
+    // 先写临时文件再替换，避免中断时留下半个文件
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(SERIES_STATE_MAGIC, 4);
+        for (long long bound : { n1, n2 }) {
+            for (int i = 0; i < 8; ++i) {
+                out.put((char)(((unsigned long long)bound >> (8 * i)) & 0xFF));
+            }
+        }
+        state.P.serialize(out);
+        state.Q.serialize(out);
+        state.B.serialize(out);
+        state.T.serialize(out);
+        if (!out) {
+            return false;
+        }
+    }
+    std::remove(path.c_str());
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+// 读取级数状态文件，失败时返回false
+bool loadSeriesState(const std::string& path, SeriesState& state, long long& n1, long long& n2) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    
+    char magic[4];
+    in.read(magic, 4);
+    if (!in || !std::equal(magic, magic + 4, SERIES_STATE_MAGIC)) {
+        std::cerr << "忽略格式不符的级数状态文件 " << path << std::endl;
+        return false;
+    }
+    unsigned long long bounds[2] = { 0, 0 };
+    for (unsigned long long& bound : bounds) {
+        for (int i = 0; i < 8; ++i) {
+            bound |= (unsigned long long)(unsigned char)in.get() << (8 * i);
+        }
+    }
+    
+    try {
+        state.P = BigInteger::deserialize(in);
+        state.Q = BigInteger::deserialize(in);
+        state.B = BigInteger::deserialize(in);
+        state.T = BigInteger::deserialize(in);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "忽略损坏的级数状态文件 " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    n1 = (long long)bounds[0];
+    n2 = (long long)bounds[1];
+    return true;
+}
+
+// 内置常数：由级数和（定点）得到常数值（定点），两者都以 10^scale 为单位
+struct ConstantDefinition {
+    std::string name;
+    std::string symbol;
+    std::string description;
+    HypergeometricSeries series;
+    std::function<BigInteger(const BigInteger& sum, int scale)> finish;
+    bool finishSqrt = false; // finish 中含一次开方和一次全精度除法，用于估计进度
+};
+
+const std::vector<ConstantDefinition>& builtinConstants() {
+    const Polynomial K({0, 1});
+    static const std::vector<ConstantDefinition> constants = {
+        { "pi", "π", "Chudnovsky级数（二分法）",
+          { Polynomial({CHUDNOVSKY_A, CHUDNOVSKY_B}), Polynomial({1}),
+            Polynomial({-1}) * Polynomial({-5, 6}) * Polynomial({-1, 2}) * Polynomial({-1, 6}),
+            Polynomial({C3_OVER_24}) * K.pow(3) },
+          [](const BigInteger& sum, int scale) {
+              Stats::beginPhase("sqrt");
+              BigInteger sqrtTerm = sqrt(BigInteger(10005).scaleByPow10(2 * scale));
+              Stats::beginPhase("division");
+              return (BigInteger(426880) * sqrtTerm).scaleByPow10(scale) / sum;
+          }, true },
+        { "e", "e", "Σ 1/k!",
+          { Polynomial({1}), Polynomial({1}), Polynomial({1}), K },
+          [](const BigInteger& sum, int) { return sum; } },
+        { "ln2", "ln2", "Σ 1/((k+1)·2^(k+1))",
+          { Polynomial({1}), Polynomial({2, 2}), Polynomial({1}), Polynomial({2}) },
+          [](const BigInteger& sum, int) { return sum; } },
+        { "zeta3", "ζ(3)", "Amdeberhan-Zeilberger级数",
+          { Polynomial({77, 250, 205}), Polynomial({1}),
+            Polynomial({-1}) * K.pow(5), Polynomial({32}) * Polynomial({1, 2}).pow(5) },
+          [](const BigInteger& sum, int) { return sum.divideSmall(64); } },
+        { "catalan", "G", "Lupas级数",
+          { Polynomial({32 * 19, 32 * 56, 32 * 40}), Polynomial({9}) * Polynomial({1, 1}).pow(3) * Polynomial({1, 2}),
+            Polynomial({-32}) * Polynomial({1, 1}).pow(3) * Polynomial({1, 2}),
+            Polynomial({3, 4}).pow(2) * Polynomial({1, 4}).pow(2) },
+          [](const BigInteger& sum, int) { return sum.divideSmall(64); } },
+        { "sqrt2", "√2", "(99/70)·(1-1/9801)^(1/2) 的二项式级数",
+          { Polynomial({1}), Polynomial({1}), Polynomial({-3, 2}), Polynomial({0, 19602}) },
+          [](const BigInteger& sum, int) { return sum.multiplySmall(99).divideSmall(70); } },
+    };
+    return constants;
+}
+
+const ConstantDefinition* findConstant(const std::string& name) {
+    for (const ConstantDefinition& constant : builtinConstants()) {
+        if (constant.name == name) {
+            return &constant;
+        }
+    }
+    return nullptr;
+}
+
+// 把定点值 value = c·10^(digits+GUARD_DIGITS) 格式化为小数点后digits位的字符串
+std::string formatFixedPoint(const BigInteger& value, int digits) {
+    std::string str = value.toString();
+    size_t fraction = digits + GUARD_DIGITS;
+    if (str.length() <= fraction) {
+        str.insert(0, fraction + 1 - str.length(), '0');
+    }
+    str.insert(str.length() - fraction, ".");
+    return str.substr(0, str.length() - GUARD_DIGITS);
+}
+
+// 二分法并行求值时的递归并行层数，使叶子任务数不少于硬件线程数
+int parallelDepthForHardware() {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    int depth = 0;
+    while ((1u << depth) < threads) {
+        ++depth;
+    }
+    return depth;
+}
+
+// --max-memory 的峰值估计（字节），系数由 --stats 的各阶段峰值实测标定：
+// 二分法求值的峰值出现在最顶层合并，约为最终 Q 每位 38 字节；落盘合并时约 28 字节；
+// 最后的除法/开方约为结果每位 112 字节
+struct MemoryPlan {
+    int parallelDepth;
+    bool spill;
+    long long seriesBytes;
+    long long finishBytes;
+};
+
+MemoryPlan planMemory(const HypergeometricSeries& series, long long terms, int digits, long long maxMemory, bool allowSpill) {
+    double stateDigits = seriesStateDigits(series, 0, terms); // 最终 Q（及 T）的位数估计
+    
+    MemoryPlan plan;
+    plan.parallelDepth = parallelDepthForHardware();
+    plan.spill = false;
+    plan.seriesBytes = (long long)(38 * stateDigits);
+    plan.finishBytes = 112LL * (digits + GUARD_DIGITS);
+    // 并行时各线程的子树同时存活，预留四分之一余量；超出预算时先退回顺序求值，再不够才落盘
+    if (plan.parallelDepth > 0 && plan.seriesBytes * 5 / 4 > maxMemory) {
+        plan.parallelDepth = 0;
+    }
+    if (allowSpill && plan.seriesBytes > maxMemory && terms > 1) {
+        plan.spill = true;
+        plan.seriesBytes = (long long)(28 * stateDigits);
+    }
+    return plan;
+}
+
+// 解析 "512M"、"4G" 形式的字节数（K/M/G 为 1024 进制），无效时返回 -1
+long long parseByteSize(const std::string& text) {
+    size_t end = 0;
+    double value = 0;
+    try {
+        value = std::stod(text, &end);
+    } catch (const std::exception& e) {
+        return -1;
+    }
+    std::string suffix = text.substr(end);
+    double unit = suffix.empty() || suffix == "B" ? 1
+                : suffix == "K" || suffix == "KB" ? 1024.0
+                : suffix == "M" || suffix == "MB" ? 1024.0 * 1024
+                : suffix == "G" || suffix == "GB" ? 1024.0 * 1024 * 1024 : 0;
+    return value > 0 && unit > 0 ? (long long)(value * unit) : -1;
+}
+
+// 级数状态的落盘求值：左右两半依次求值，各分量分别写成文件后释放；
+// 合并时每次只读入当前这次乘法需要的两个分量，避免两半的全部分量同时驻留内存
+void spillSeriesComponent(const std::string& path, const BigInteger& value) {
+    std::ofstream out(path, std::ios::binary);
+    value.serialize(out);
+    if (!out) {
+        throw std::runtime_error("无法写入落盘文件 " + path);
+    }
+}
+
+BigInteger loadSpilledComponent(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("无法读取落盘文件 " + path);
+    }
+    return BigInteger::deserialize(in);
+}
+
+SeriesState evaluateSeriesSpilled(const HypergeometricSeries& series, long long n1, long long n2,
+                                  const std::string& prefix, ProgressReporter* progress) {
+    long long m = (n1 + n2) / 2;
+    const char* names[] = { "P", "Q", "B", "T" };
+    for (int half = 0; half < 2; ++half) {
+        // 左半要提供 P 参与合并，右半（最右侧路径）不需要
+        SeriesState state = half == 0 ? evaluateSeries(series, n1, m, 0, progress, true)
+                                      : evaluateSeries(series, m, n2, 0, progress, false);
+        BigInteger* parts[] = { &state.P, &state.Q, &state.B, &state.T };
+        for (int i = 0; i < 4; ++i) {
+            spillSeriesComponent(prefix + std::to_string(half) + "." + names[i], *parts[i]);
+            *parts[i] = BigInteger();
+        }
+    }
+    
+    auto load = [&](int half, const char* name) { return loadSpilledComponent(prefix + std::to_string(half) + "." + name); };
+    SeriesState result;
+    // T = rB·rQ·lT + lB·lP·rT
+    BigInteger rightB = load(1, "B");
+    result.T = load(1, "Q") * load(0, "T");
+    result.T = result.T * rightB;
+    BigInteger leftB = load(0, "B");
+    BigInteger term = load(0, "P") * load(1, "T");
+    term = term * leftB;
+    result.T = result.T + term;
+    term = BigInteger();
+    result.Q = load(0, "Q") * load(1, "Q");
+    result.B = leftB * rightB;
+    if (progress) {
+        progress->advance(mergeWork(result.T.digitCount() / 2.0));
+    }
+    for (int half = 0; half < 2; ++half) {
+        for (const char* name : names) {
+            std::remove((prefix + std::to_string(half) + "." + name).c_str());
+        }
+    }
+    return result;
+}
+
+// 最后的除法（及开方）的预计工作量，与级数合并同一单位
+unsigned long long finishWork(const ConstantDefinition& constant, int digits) {
+    double scale = digits + GUARD_DIGITS;
+    return divisionWork(scale) + (constant.finishSqrt ? sqrtWork(scale) + divisionWork(scale) : 0);
+}
+
+// 用超几何级数引擎计算常数到小数点后digits位
+// 由 [0, N) 的级数状态做最后的除法（及开方）并格式化；按值接收状态，用完的分量立即释放。
+// progress 非空时其总量应包含 finishWork，各步完成后推进，最后结束报告
+std::string finishConstant(const ConstantDefinition& constant, SeriesState state, int digits,
+                           std::chrono::high_resolution_clock::time_point startTime, ProgressReporter* progress = nullptr) {
+    const int SCALE = digits + GUARD_DIGITS;
+    
+    if (progress) {
+        progress->beginStep(divisionWork(SCALE));
+    }
+    // normalize 阶段只含分母 B·Q 的乘积和截断，级数和的除法记入 division
+    Stats::beginPhase("normalize");
+    state.P = BigInteger();
+    BigInteger denominator = state.B * state.Q;
+    state.B = state.Q = BigInteger();
+    // 商只需 SCALE 位精度：分子分母同时截去低位，使分母只保留 SCALE + GUARD_DIGITS 位，误差仍在保护位内
+    long long drop = std::max(0LL, (long long)denominator.digitCount() - (SCALE + GUARD_DIGITS));
+    denominator = denominator.scaleByPow10(-drop);
+    BigInteger numerator = state.T.scaleByPow10(SCALE - drop);
+    state.T = BigInteger();
+    Stats::beginPhase("division");
+    BigInteger sum = numerator / denominator;
+    numerator = denominator = BigInteger();
+    if (progress) {
+        progress->endStep();
+        progress->beginStep(finishWork(constant, digits) - divisionWork(SCALE));
+    }
+    BigInteger value = constant.finish(sum, SCALE);
+    Stats::endPhase();
+    if (progress) {
+        progress->endStep();
+        progress->finish();
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = endTime - startTime;
+    std::cout << "计算完成！用时 " << elapsed.count() << " 秒" << std::endl;
+    
+    Stats::beginPhase("conversion");
+    std::string result = formatFixedPoint(value, digits);
+    Stats::endPhase();
+    return result;
+}
+
+// cacheDir 非空时复用其中保存的 [0, N) 级数状态，只计算新增的项并写回；
+// maxMemory 大于0时先报告预计峰值内存，再按预算选择并行、顺序或落盘求值（落盘文件写在 spillDir），
+// 最省内存的策略仍超出预算时不开始计算，直接报告可达到的最低峰值
+std::string calculateConstant(const ConstantDefinition& constant, int digits, const std::string& cacheDir = "",
+                              long long maxMemory = 0, const std::string& spillDir = ".") {
+    std::cout << "使用" << constant.description << "计算" << constant.symbol << "（小数点后" << digits << "位）..." << std::endl;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    long long terms = seriesTermsNeeded(constant.series, digits);
+    
+    MemoryPlan plan = { parallelDepthForHardware(), false, 0, 0 };
+    if (maxMemory > 0) {
+        // 落盘合并得到的状态不含 P，无法写入缓存供以后续算
+        plan = planMemory(constant.series, terms, digits, maxMemory, cacheDir.empty());
+        const double MB = 1024.0 * 1024;
+        long long projected = std::max(plan.seriesBytes, plan.finishBytes);
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(1)
+               << "预计峰值内存 " << projected / MB << " MB（级数 " << plan.seriesBytes / MB
+               << " MB，除法 " << plan.finishBytes / MB << " MB），上限 " << maxMemory / MB << " MB";
+        std::cout << report.str() << std::endl;
+        if (projected > maxMemory) {
+            std::ostringstream error;
+            error << std::fixed << std::setprecision(1) << "内存上限过低：最省内存的策略预计仍需 " << projected / MB
+                  << " MB" << (cacheDir.empty() ? "" : "（使用 --cache-dir 时不能落盘求值）");
+            throw std::runtime_error(error.str());
+        }
+        std::cout << "求值策略: " << (plan.spill ? "顺序求值，两半落盘后逐分量合并"
+                                     : plan.parallelDepth > 0 ? "并行求值" : "顺序求值") << std::endl;
+    }
+    
+    SeriesState state;
+    long long cachedTerms = 0;
+    std::string cachePath = cacheDir.empty() ? "" : cacheDir + "/" + constant.name + ".series";
+    long long cachedStart = 0;
+    if (!cachePath.empty() && (!loadSeriesState(cachePath, state, cachedStart, cachedTerms) || cachedStart != 0)) {
+        cachedTerms = 0;
+    }
+    
+    // 进度覆盖级数求值（及与缓存状态的合并）和最后的除法、开方
+    unsigned long long totalWork = finishWork(constant, digits);
+    if (cachedTerms < terms) {
+        totalWork += seriesWork(constant.series, cachedTerms, terms)
+                   + (cachedTerms > 0 ? mergeWork(seriesStateDigits(constant.series, 0, terms) / 2) : 0);
+    }
+    ProgressReporter progress(constant.symbol, totalWork);
+    
+    Stats::beginPhase("series");
+    if (cachedTerms >= terms) {
+        // 缓存的项数已足够，多出的项只会让结果更精确
+        std::cout << "缓存已包含" << cachedTerms << "项，无需计算级数" << std::endl;
+        terms = cachedTerms;
+    } else {
+        std::cout << "二分法计算第" << cachedTerms << "到" << terms << "项..." << std::endl;
+        SeriesState added = plan.spill ? evaluateSeriesSpilled(constant.series, cachedTerms, terms, spillDir + "/" + constant.name + "_spill_", &progress)
+                                       : evaluateSeries(constant.series, cachedTerms, terms, plan.parallelDepth, &progress, !cachePath.empty());
+        if (cachedTerms > 0) {
+            unsigned long long work = mergeWork((state.T.digitCount() + added.T.digitCount()) / 2.0);
+            state = mergeSeriesStates(std::move(state), std::move(added));
+            progress.advance(work);
+        } else {
+            state = std::move(added);
+        }
+        
+        if (!cachePath.empty()) {
+            Stats::beginPhase("cache");
+            if (saveSeriesState(cachePath, 0, terms, state)) {
+                std::cout << "级数状态（" << terms << "项）已缓存到 " << cachePath << std::endl;
+            } else {
+                std::cerr << "无法写入缓存 " << cachePath << std::endl;
+            }
+        }
+    }
+    
+    return finishConstant(constant, std::move(state), digits, startTime, &progress);
+}
+
+// ---------------- Machin类arctan公式 ----------------
+
+// π = Σ coefficient · arctan(1/x)
+struct MachinTerm {
+    long long coefficient;
+    long long x;
+};
+
+struct MachinFormula {
+    std::string name;
+    std::string description;
+    std::vector<MachinTerm> terms;
+};
+
+const std::vector<MachinFormula>& machinFormulas() {
+    static const std::vector<MachinFormula> formulas = {
+        { "machin", "Machin公式", { { 16, 5 }, { -4, 239 } } },
+        { "takano", "Takano公式", { { 48, 49 }, { 128, 57 }, { -20, 239 }, { 48, 110443 } } },
+        { "stormer", "Størmer公式", { { 176, 57 }, { 28, 239 }, { -48, 682 }, { 96, 12943 } } },
+    };
+    return formulas;
+}
+
+const MachinFormula* findMachinFormula(const std::string& name) {
+    for (const MachinFormula& formula : machinFormulas()) {
+        if (formula.name == name) {
+            return &formula;
+        }
+    }
+    return nullptr;
+}
+
+// x·arctan(1/x) = Σ 1/(2k+1) · Π_{j=1..k} (-1/x²)
+HypergeometricSeries arctanInverseSeries(long long x) {
+    return { Polynomial({1}), Polynomial({1, 2}), Polynomial({-1}), Polynomial({x * x}) };
+}
+
+// 用Machin类公式计算π：各arctan级数在独立线程上二分法求值，只在最后各做一次除法
+std::string calculatePiMachin(const MachinFormula& formula, int digits) {
+    std::cout << "使用" << formula.description << "计算π（小数点后" << digits << "位）..." << std::endl;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    const int SCALE = digits + GUARD_DIGITS;
+    
+    std::vector<HypergeometricSeries> series;
+    std::vector<long long> terms;
+    std::vector<unsigned long long> divisionWorks;
+    unsigned long long totalWork = 0;
+    for (const MachinTerm& term : formula.terms) {
+        series.push_back(arctanInverseSeries(term.x));
+        terms.push_back(seriesTermsNeeded(series.back(), digits));
+        // 级数求值及最后的除法；除数为整个状态，比结果长 stateDigits/SCALE 倍，乘法按此比例拆成多段
+        double stateDigits = seriesStateDigits(series.back(), 0, terms.back());
+        divisionWorks.push_back((unsigned long long)(divisionWork(SCALE) * std::max(1.0, stateDigits / SCALE)));
+        totalWork += seriesWork(series.back(), 0, terms.back()) + divisionWorks.back();
+    }
+    std::cout << "并行计算" << formula.terms.size() << "个arctan级数..." << std::endl;
+    
+    ProgressReporter progress("π", totalWork);
+    
+    Stats::beginPhase("series");
+    std::vector<SeriesState> states(series.size());
+    {
+        std::vector<std::future<SeriesState>> futures;
+        for (size_t i = 0; i < series.size(); ++i) {
+            futures.push_back(std::async(std::launch::async, evaluateSeries, std::cref(series[i]), 0LL, terms[i], 0, &progress, false));
+        }
+        for (size_t i = 0; i < series.size(); ++i) {
+            states[i] = futures[i].get();
+        }
+    }
+    
+    Stats::beginPhase("division");
+    BigInteger pi(0);
+    for (size_t i = 0; i < series.size(); ++i) {
+        const SeriesState& state = states[i];
+        progress.beginStep(divisionWorks[i]);
+        BigInteger arctan = state.T.scaleByPow10(SCALE) / (state.B * state.Q * BigInteger(formula.terms[i].x));
+        pi = pi + BigInteger(formula.terms[i].coefficient) * arctan;
+        progress.endStep();
+    }
+    Stats::endPhase();
+    progress.finish();
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = endTime - startTime;
+    std::cout << "计算完成！用时 " << elapsed.count() << " 秒" << std::endl;
+    
+    Stats::beginPhase("conversion");
+    std::string result = formatFixedPoint(pi, digits);
+    Stats::endPhase();
+    return result;
+}
+
+// ---------------- 多进程分片计算（--shards / --worker） ----------------
+
+// 工作进程：计算 [n1, n2) 的级数状态并写入文件。verify 时对乘法做模校验，
+// 并把完成的校验次数写入 path.checks 供协调进程汇总；校验失败时抛出 ProductCheckError
+int runShardWorker(const ConstantDefinition& constant, long long n1, long long n2, const std::string& path, bool verify) {
+    if (verify) {
+        BigInteger::enableProductCheck();
+    }
+    SeriesState state = evaluateSeries(constant.series, n1, n2, parallelDepthForHardware(), nullptr);
+    if (!saveSeriesState(path, n1, n2, state)) {
+        std::cerr << "无法写入分片文件 " << path << std::endl;
+        return 1;
+    }
+    if (verify) {
+        std::ofstream checks(path + ".checks");
+        checks << BigInteger::productChecks() << std::endl;
+    }
+    return 0;
+}
+
+// 工作进程乘法校验失败时的退出码，与主程序校验失败的退出码一致
+const int VERIFY_FAILED_EXIT_CODE = 2;
+
+// std::system 的返回值在 POSIX 上是 wait 状态，需解码出退出码或终止信号
+bool exitedWithCode(int status, int code) {
+#ifndef _WIN32
+    return status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == code;
+#else
+    return status == code;
+#endif
+}
+
+std::string describeExitStatus(int status) {
+#ifndef _WIN32
+    if (status != -1 && WIFSIGNALED(status)) {
+        return "被信号 " + std::to_string(WTERMSIG(status)) + " 终止";
+    }
+    if (status != -1 && WIFEXITED(status)) {
+        status = WEXITSTATUS(status);
+    }
+#endif
+    return "退出码 " + std::to_string(status);
+}
+
+// 协调进程：把项区间均分给 shards 个工作进程，合并各分片后做最后的开方和除法。
+// workerCommand 默认为本程序；换成转发到其他节点的脚本（共享分片目录）即可跨机运行。
+// 工作进程使用同一调优文件，verify 时同样做乘法模校验，其校验次数累加到 workerChecks
+std::string calculateConstantSharded(const ConstantDefinition& constant, int digits, int shards,
+                                     const std::string& workerCommand, const std::string& shardDir,
+                                     const std::string& tuningFile, bool verify, unsigned long long& workerChecks) {
+    std::cout << "使用" << constant.description << "计算" << constant.symbol << "（小数点后" << digits << "位）..." << std::endl;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    long long terms = seriesTermsNeeded(constant.series, digits);
+    shards = (int)std::max(1LL, std::min((long long)shards, terms));
+    std::cout << "把" << terms << "项分给" << shards << "个工作进程..." << std::endl;
+    
+    Stats::beginPhase("series");
+    std::vector<std::string> paths;
+    std::vector<int> exitCodes(shards, 0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < shards; ++i) {
+        long long n1 = terms * i / shards;
+        long long n2 = terms * (i + 1) / shards;
+        paths.push_back(shardDir + "/" + constant.name + "_shard_" + std::to_string(i) + ".bsp");
+        std::string command = "\"" + workerCommand + "\" --worker " + constant.name + " " + std::to_string(n1)
+                              + " " + std::to_string(n2) + " \"" + paths.back() + "\" --tuning-file \"" + tuningFile + "\""
+                              + (verify ? " --verify" : "");
+        workers.emplace_back([&exitCodes, i, command] { exitCodes[i] = std::system(command.c_str()); });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (int i = 0; i < shards; ++i) {
+        if (exitedWithCode(exitCodes[i], VERIFY_FAILED_EXIT_CODE)) {
+            throw ProductCheckError("分片 " + std::to_string(i) + " 的工作进程乘法校验失败");
+        }
+        if (exitCodes[i] != 0) {
+            throw std::runtime_error("分片 " + std::to_string(i) + " 的工作进程失败，" + describeExitStatus(exitCodes[i]));
+        }
+    }
+    if (verify) {
+        for (const std::string& path : paths) {
+            std::ifstream checks(path + ".checks");
+            unsigned long long count = 0;
+            if (!(checks >> count)) {
+                throw std::runtime_error("缺少工作进程的校验记录 " + path + ".checks");
+            }
+            workerChecks += count;
+            checks.close();
+            std::remove((path + ".checks").c_str());
+        }
+    }
+    
+    // 按区间顺序读入，逐层两两合并
+    Stats::beginPhase("merge");
+    std::vector<SeriesState> states(shards);
+    long long expectedStart = 0;
+    for (int i = 0; i < shards; ++i) {
+        long long n1 = 0, n2 = 0;
+        if (!loadSeriesState(paths[i], states[i], n1, n2) || n1 != expectedStart) {
+            throw std::runtime_error("分片文件无效: " + paths[i]);
+        }
+        expectedStart = n2;
+        std::remove(paths[i].c_str());
+    }
+    if (expectedStart != terms) {
+        throw std::runtime_error("分片未覆盖全部项");
+    }
+    while (states.size() > 1) {
+        std::vector<SeriesState> merged;
+        for (size_t i = 0; i + 1 < states.size(); i += 2) {
+            merged.push_back(mergeSeriesStates(std::move(states[i]), std::move(states[i + 1])));
+        }
+        if (states.size() % 2 == 1) {
+            merged.push_back(std::move(states.back()));
+        }
+        states.swap(merged);
+    }
+    
+    return finishConstant(constant, std::move(states[0]), digits, startTime);
+}
+
+// ---------------- 流式数字生成（--stream） ----------------
+
+// 按块拉取已确认的数字：分阶段倍增精度，每阶段在后台线程扩展级数状态，
+// 只输出在误差界两侧取值一致的数字，下一阶段在消费者处理当前块时预先计算。
+// 首阶段只算约一个块的精度，第一块尽早输出
+class DigitStream {
+private:
+    static const int STAGE_MARGIN = 20;
+
+    const ConstantDefinition& constant;
+    int digits;
+    size_t blockSize;
+    
+    std::string confirmed;   // 已确认的输出（含整数部分和小数点）
+    size_t emitted = 0;      // 已交给调用者的字符数
+    size_t targetLength = 0; // 完整输出的长度，首个阶段完成后才知道
+    
+    // 分阶段状态：仅由后台任务访问
+    SeriesState state;
+    long long stateTerms = 0;
+    int nextPrecision;
+    std::future<std::pair<int, BigInteger>> pending;
+
+    bool complete() const {
+        return targetLength > 0 && confirmed.size() >= targetLength;
+    }
+
+    // 扩展级数状态到 precision 位所需的项数，返回定点值
+    std::pair<int, BigInteger> computeStage(int precision) {
+        long long terms = seriesTermsNeeded(constant.series, precision);
+        if (terms > stateTerms) {
+            Stats::beginPhase("series");
+            SeriesState added = evaluateSeries(constant.series, stateTerms, terms, parallelDepthForHardware(), nullptr);
+            state = stateTerms > 0 ? mergeSeriesStates(std::move(state), std::move(added)) : std::move(added);
+            stateTerms = terms;
+        }
+        const int scale = precision + GUARD_DIGITS;
+        Stats::beginPhase("division");
+        BigInteger value = constant.finish(state.T.scaleByPow10(scale) / (state.B * state.Q), scale);
+        Stats::endPhase();
+        return { precision, value };
+    }
+
+    void launchStage() {
+        int precision = nextPrecision;
+        pending = std::async(std::launch::async, [this, precision] { return computeStage(precision); });
+    }
+
+    // 取回一个阶段的结果并确认数字：误差界两侧的值格式化后公共前缀中的数字是确定的
+    void runStage() {
+        if (!pending.valid()) {
+            launchStage();
+        }
+        std::pair<int, BigInteger> stage = pending.get();
+        
+        const BigInteger ERROR_BOUND(1000); // 以定点最低位计，远小于 10^GUARD_DIGITS
+        std::string lo = formatFixedPoint(stage.second - ERROR_BOUND, stage.first);
+        std::string hi = formatFixedPoint(stage.second + ERROR_BOUND, stage.first);
+        if (targetLength == 0) {
+            targetLength = lo.find('.') + 1 + digits;
+        }
+        size_t common = std::mismatch(lo.begin(), lo.end(), hi.begin()).first - lo.begin();
+        common = std::min(common, targetLength);
+        if (common > confirmed.size()) {
+            confirmed = lo.substr(0, common);
+        }
+        
+        if (!complete()) {
+            // 倍增精度，到达目标后每次再多算 STAGE_MARGIN 位以越过连续的9或0
+            nextPrecision = stage.first < digits ? std::min(2 * stage.first, digits + STAGE_MARGIN)
+                                                 : stage.first + STAGE_MARGIN;
+            launchStage();
+        }
+    }
+
+public:
+    // blockSize 为0时按输出长度取约十分之一，限制在 [10, 1000] 内
+    DigitStream(const ConstantDefinition& constant, int digits, int blockSize = 0)
+        : constant(constant), digits(digits),
+          blockSize(blockSize > 0 ? blockSize : std::min(1000, std::max(10, digits / 10))),
+          nextPrecision(std::min((int)this->blockSize + STAGE_MARGIN, digits + STAGE_MARGIN)) {
+    }
+
+    ~DigitStream() {
+        if (pending.valid()) {
+            pending.wait();
+        }
+    }
+
+    // 取下一块已确认的数字，全部输出后返回false
+    bool next(std::string& block) {
+        if (emitted >= targetLength && targetLength > 0) {
+            return false;
+        }
+        
+        while (confirmed.size() - emitted < blockSize && !complete()) {
+            runStage();
+        }
+        
+        size_t count = std::min(blockSize, confirmed.size() - emitted);
+        block = confirmed.substr(emitted, count);
+        emitted += count;
+        return count > 0;
+    }
+};
+
+// ---------------- 基准测试（--bench） ----------------
+
+// 单条基准测试结果；limb 即本实现中的一位十进制数字
+struct BenchResult {
+    std::string op;
+    long long digits;
+    long long reps;
+    double nsPerOp;
+    double nsPerLimb;
+    double limbsPerSec;
+    double scalingExponent; // 相对上一规模的 log(t2/t1)/log(n2/n1)，首个规模为 NaN
+};
+
+// 生成指定位数的随机正整数（最高位非零）
+BigInteger randomBigInteger(long long digits, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(0, 9);
+    std::string str(digits, '0');
+    for (char& c : str) {
+        c = '0' + dist(rng);
+    }
+    str[0] = '1' + dist(rng) % 9;
+    return BigInteger(str);
+}
+
+// 重复执行 op 直到累计至少 minSeconds，返回每次耗时（纳秒）
+double timeOperation(const std::function<void()>& op, double minSeconds, long long& reps) {
+    reps = 0;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed(0);
+    do {
+        op();
+        ++reps;
+        elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    } while (elapsed.count() < minSeconds);
+    return elapsed.count() * 1e9 / reps;
+}
+
+// 对 BigInteger 各运算和各π算法按规模扫描计时，以JSON或CSV输出到 out
+void runBenchmark(long long maxDigits, int piMaxDigits, const std::string& format, std::ostream& out) {
+    const double MIN_SECONDS = 0.2;
+    std::mt19937 rng(20240601);
+    std::vector<BenchResult> results;
+    
+    auto record = [&](const std::string& op, long long digits, const std::function<void()>& fn) {
+        BenchResult r;
+        r.op = op;
+        r.digits = digits;
+        r.nsPerOp = timeOperation(fn, MIN_SECONDS, r.reps);
+        r.nsPerLimb = r.nsPerOp / digits;
+        r.limbsPerSec = digits * 1e9 / r.nsPerOp;
+        r.scalingExponent = std::nan("");
+        for (auto it = results.rbegin(); it != results.rend(); ++it) {
+            if (it->op == op) {
+                r.scalingExponent = std::log(r.nsPerOp / it->nsPerOp) / std::log((double)digits / it->digits);
+                break;
+            }
+        }
+        results.push_back(r);
+        std::cerr << "bench " << op << " @ " << digits << ": " << r.nsPerOp << " ns/op" << std::endl;
+    };
+    
+    for (long long n = 10; n <= maxDigits; n *= 10) {
+        BigInteger a = randomBigInteger(n, rng);
+        BigInteger b = randomBigInteger(n, rng);
+        BigInteger wide = randomBigInteger(2 * n, rng);
+        BigInteger base = randomBigInteger(std::max(1LL, n / 8), rng);
+        std::string text = a.toString();
+        BigInteger sink;
+        
+        record("add", n, [&] { sink = a + b; });
+        record("sub", n, [&] { sink = a - b; });
+        record("mul", n, [&] { sink = a * b; });
+        record("divmod", n, [&] { sink = wide.divmod(a).first; });
+        record("pow", n, [&] { sink = base.pow(8); });
+        record("sqrt", n, [&] { sink = sqrt(wide); });
+        record("toString", n, [&] { text = a.toString(); });
+        record("parse", n, [&] { sink = BigInteger(text); });
+    }
+    
+    // π算法计时时屏蔽其控制台输出和进度报告，避免把I/O算进去
+    ProgressReporter::setEnabled(false);
+    std::ostringstream discard;
+    std::streambuf* saved = std::cout.rdbuf(discard.rdbuf());
+    for (int n = 10; n <= piMaxDigits; n *= 10) {
+        record("pi_chudnovsky", n, [&] { calculatePi(n); discard.str(""); });
+        record("pi_optimized", n, [&] { calculatePiOptimized(n); discard.str(""); });
+        record("pi_ramanujan", n, [&] { calculatePiRamanujan(n); discard.str(""); });
+        for (const MachinFormula& formula : machinFormulas()) {
+            record("pi_" + formula.name, n, [&] { calculatePiMachin(formula, n); discard.str(""); });
+        }
+        record("pi_binsplit", n, [&] { calculateConstant(*findConstant("pi"), n); discard.str(""); });
+        // --verify 的BBP尾部校验，对照结果不计时
+        std::string pi = calculateConstant(*findConstant("pi"), n);
+        discard.str("");
+        long long hexPosition = 0;
+        record("verify_bbp", n, [&] { verifyPiTail(pi, n, hexPosition); });
+    }
+    std::cout.rdbuf(saved);
+    
+    auto number = [](double v) {
+        std::ostringstream oss;
+        if (std::isnan(v)) {
+            oss << "null";
+        } else {
+            oss << std::setprecision(6) << v;
+        }
+        return oss.str();
+    };
+    
+    if (format == "csv") {
+        out << "op,digits,reps,ns_per_op,ns_per_limb,limbs_per_sec,scaling_exponent\n";
+        for (const BenchResult& r : results) {
+            std::string exponent = std::isnan(r.scalingExponent) ? "" : number(r.scalingExponent);
+            out << r.op << "," << r.digits << "," << r.reps << "," << number(r.nsPerOp) << ","
+                << number(r.nsPerLimb) << "," << number(r.limbsPerSec) << "," << exponent << "\n";
+        }
+    } else {
+        out << "[\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << "  {\"op\": \"" << r.op << "\", \"digits\": " << r.digits << ", \"reps\": " << r.reps
+                << ", \"ns_per_op\": " << number(r.nsPerOp) << ", \"ns_per_limb\": " << number(r.nsPerLimb)
+                << ", \"limbs_per_sec\": " << number(r.limbsPerSec)
+                << ", \"scaling_exponent\": " << number(r.scalingExponent) << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+    }
+}
+
+// ---------------- 阈值调优（--tune） ----------------
+
+// 在一组递增规模上比较相邻两档算法，返回新算法连续两次更快的最小规模
+int findCrossover(const std::vector<int>& sizes, const std::function<double(int, bool)>& timeAt) {
+    int firstFaster = -1;
+    for (int n : sizes) {
+        double oldTier = timeAt(n, false);
+        double newTier = timeAt(n, true);
+        std::cout << "  " << n << " 位: " << std::setprecision(4) << oldTier / 1000 << " us vs "
+                  << newTier / 1000 << " us" << std::endl;
+        if (newTier < oldTier) {
+            if (firstFaster > 0) {
+                return firstFaster;
+            }
+            firstFaster = n;
+        } else {
+            firstFaster = -1;
+        }
+    }
+    return firstFaster > 0 ? firstFaster : sizes.back();
+}
+
+// 在本机上测定Karatsuba乘法和牛顿除法的切换阈值，写入调优文件
+bool runTuning(const std::string& path) {
+    const double MIN_SECONDS = 0.05;
+    std::mt19937 rng(20240601);
+    long long reps = 0;
+    
+    std::vector<int> sizes;
+    for (double n = 8; n <= 2048; n *= 1.25) {
+        sizes.push_back((int)n);
+    }
+    
+    // 阈值为 n 时顶层走Karatsuba、子问题走朴素乘法；阈值为 n+1 时全程朴素乘法
+    std::cout << "测定朴素乘法/Karatsuba切换点..." << std::endl;
+    int karatsuba = findCrossover(sizes, [&](int n, bool useNew) {
+        BigInteger a = randomBigInteger(n, rng);
+        BigInteger b = randomBigInteger(n, rng);
+        BigInteger::setKaratsubaThreshold(useNew ? n : n + 1);
+        return timeOperation([&] { BigInteger c = a * b; }, MIN_SECONDS, reps);
+    });
+    BigInteger::setKaratsubaThreshold(karatsuba);
+    
+    // 除数 m 位、被除数 2m 位
+    std::cout << "测定长除法/牛顿除法切换点..." << std::endl;
+    std::vector<int> divisorSizes;
+    for (int n : sizes) {
+        if (n >= 20) {
+            divisorSizes.push_back(n);
+        }
+    }
+    int newton = findCrossover(divisorSizes, [&](int m, bool useNew) {
+        BigInteger a = randomBigInteger(2 * m, rng);
+        BigInteger b = randomBigInteger(m, rng);
+        BigInteger::setNewtonDivisionThreshold(useNew ? m : m + 1);
+        return timeOperation([&] { BigInteger q = a / b; }, MIN_SECONDS, reps);
+    });
+    BigInteger::setNewtonDivisionThreshold(newton);
+    
+    std::cout << "karatsuba_threshold=" << BigInteger::getKaratsubaThreshold() << std::endl;
+    std::cout << "newton_division_threshold=" << BigInteger::getNewtonDivisionThreshold() << std::endl;
+    return BigInteger::saveTuning(path);
+}
+
 int main(int argc, char* argv[]) {
     int digits = 100; // 默认计算100位小数
     std::string algorithm = "chudnovsky"; // 默认使用Chudnovsky算法
+    bool verify = false; // 是否校验结果
+    bool stats = false; // 是否输出运行统计
+    std::string cacheDir; // 级数状态缓存目录，空表示不缓存
+    bool stream = false; // 是否边计算边输出已确认的数字
+    long long maxMemory = 0; // 峰值内存上限（字节），0表示不限制
+    int streamBlock = 0; // 流式输出的块大小（字符），0表示按位数自动选取
+    int shards = 0; // 工作进程数，0表示单进程计算
+    std::string workerCommand = argv[0];
+    std::string shardDir = ".";
+    std::vector<std::string> workerArgs; // --worker 模式的参数：常数 起始项 结束项 文件
+    bool bench = false; // 是否运行基准测试
+    long long benchMaxDigits = 10000;
+    int benchPiMaxDigits = 1000;
+    std::string benchFormat = "json";
+    bool tune = false; // 是否测定算法切换阈值
+    std::string tuningFile = "bigint_tuning.txt";
     
     // 处理命令行参数
     for (int i = 1; i < argc; ++i) {
@@ -582,7 +1650,7 @@ int main(int argc, char* argv[]) {
                 std::cerr << "请在 " << arg << " 参数后指定位数" << std::endl;
                 return 1;
             }
-        } else if (arg == "-a" || arg == "--algorithm") {
+        } else if (arg == "-a" || arg == "--algorithm" || arg == "-c" || arg == "--constant") {
             if (i + 1 < argc) {
                 algorithm = argv[i + 1];
                 ++i;
@@ -590,11 +1658,115 @@ int main(int argc, char* argv[]) {
                 std::cerr << "请在 " << arg << " 参数后指定算法" << std::endl;
                 return 1;
             }
+        } else if (arg == "--verify") {
+            verify = true;
+        } else if (arg == "--worker") {
+            if (i + 4 >= argc) {
+                std::cerr << "用法: --worker 常数 起始项 结束项 文件" << std::endl;
+                return 1;
+            }
+            workerArgs.assign(argv + i + 1, argv + i + 5);
+            i += 4;
+        } else if (arg == "--shards" || arg == "--worker-command" || arg == "--shard-dir") {
+            if (i + 1 >= argc) {
+                std::cerr << "请在 " << arg << " 参数后指定取值" << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (arg == "--worker-command") {
+                workerCommand = value;
+            } else if (arg == "--shard-dir") {
+                shardDir = value;
+            } else {
+                try {
+                    shards = std::stoi(value);
+                    if (shards < 1) {
+                        throw std::invalid_argument(value);
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "无效的分片数: " << value << std::endl;
+                    return 1;
+                }
+            }
+        } else if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--stream-block") {
+            try {
+                if (i + 1 >= argc || (streamBlock = std::stoi(argv[i + 1])) <= 0) {
+                    throw std::invalid_argument(arg);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "请在 " << arg << " 参数后指定正整数块大小" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--max-memory") {
+            if (i + 1 >= argc || (maxMemory = parseByteSize(argv[i + 1])) <= 0) {
+                std::cerr << "请在 " << arg << " 参数后指定内存上限，如 512M、4G" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--cache-dir") {
+            if (i + 1 < argc) {
+                cacheDir = argv[++i];
+            } else {
+                std::cerr << "请在 " << arg << " 参数后指定目录" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "--tune") {
+            tune = true;
+        } else if (arg == "--tuning-file") {
+            if (i + 1 < argc) {
+                tuningFile = argv[++i];
+            } else {
+                std::cerr << "请在 " << arg << " 参数后指定文件" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--bench") {
+            bench = true;
+        } else if (arg == "--bench-max" || arg == "--bench-pi-max" || arg == "--bench-format") {
+            if (i + 1 >= argc) {
+                std::cerr << "请在 " << arg << " 参数后指定取值" << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            try {
+                if (arg == "--bench-max") {
+                    benchMaxDigits = std::min(std::stoll(value), 10000000LL);
+                } else if (arg == "--bench-pi-max") {
+                    benchPiMaxDigits = std::stoi(value);
+                } else if (value == "json" || value == "csv") {
+                    benchFormat = value;
+                } else {
+                    throw std::invalid_argument(value);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "无效的取值: " << value << std::endl;
+                return 1;
+            }
         } else if (arg == "-h" || arg == "--help") {
             std::cout << "用法: " << argv[0] << " [选项]" << std::endl;
             std::cout << "选项:" << std::endl;
             std::cout << "  -d, --digits N      计算π到小数点后N位" << std::endl;
-            std::cout << "  -a, --algorithm ALG 使用指定算法 (chudnovsky, optimized, ramanujan)" << std::endl;
+            std::cout << "  -a, --algorithm ALG 使用指定算法 (chudnovsky, optimized, ramanujan, machin, takano, stormer)" << std::endl;
+            std::cout << "  -c, --constant C    用超几何级数引擎计算常数 (pi, e, ln2, zeta3, catalan, sqrt2)" << std::endl;
+            std::cout << "  --shards N          把常数级数分给N个本地工作进程计算后合并" << std::endl;
+            std::cout << "  --worker-command C  启动工作进程的程序 (默认本程序，可换成转发到其他节点的脚本)" << std::endl;
+            std::cout << "  --shard-dir DIR     分片文件及 --max-memory 落盘文件的目录 (默认当前目录)" << std::endl;
+            std::cout << "  --stream            边计算边分块输出已确认的数字（常数引擎，默认π）" << std::endl;
+            std::cout << "  --stream-block N    流式输出的块大小 (默认约为位数的1/10，范围10~1000)" << std::endl;
+            std::cout << "  --cache-dir DIR     缓存常数级数的二分法状态，提高位数重算时只计算新增项" << std::endl;
+            std::cout << "  --max-memory SIZE   限制峰值内存（如 512M、4G），先报告预计峰值再选择求值策略（常数引擎，默认π）" << std::endl;
+            std::cout << "  --verify            用BBP公式独立校验π结果的尾部，并对大乘法做模素数校验" << std::endl;
+            std::cout << "  --bench             运行基准测试，结果输出到标准输出" << std::endl;
+            std::cout << "  --bench-max N       基准测试的最大操作数位数 (默认10000，最大10^7)" << std::endl;
+            std::cout << "  --bench-pi-max N    π算法基准测试的最大位数 (默认1000)" << std::endl;
+            std::cout << "  --bench-format F    基准测试输出格式 (json, csv)" << std::endl;
+            std::cout << "  --stats             结束时输出JSON格式的运行统计（调用次数、内存峰值、各阶段耗时）" << std::endl;
+            std::cout << "  --tune              测定本机的乘法/除法算法切换阈值并写入调优文件" << std::endl;
+            std::cout << "  --tuning-file F     调优文件路径 (默认bigint_tuning.txt，启动时自动加载)" << std::endl;
             std::cout << "  -h, --help          显示此帮助信息" << std::endl;
             return 0;
         } else {
@@ -612,28 +1784,115 @@ int main(int argc, char* argv[]) {
         }
     }
     
-    std::cout << "计算π到小数点后" << digits << "位，使用" << algorithm << "算法" << std::endl;
+    if (tune) {
+        if (!runTuning(tuningFile)) {
+            std::cerr << "无法写入调优文件 " << tuningFile << std::endl;
+            return 1;
+        }
+        std::cout << "调优结果已保存到 " << tuningFile << std::endl;
+        return 0;
+    }
+    
+    BigInteger::loadTuning(tuningFile);
+    
+    // 工作进程只计算一个分片并写文件
+    if (!workerArgs.empty()) {
+        const ConstantDefinition* constant = findConstant(workerArgs[0]);
+        if (!constant) {
+            std::cerr << "未知常数: " << workerArgs[0] << std::endl;
+            return 1;
+        }
+        try {
+            long long n1 = std::stoll(workerArgs[1]);
+            long long n2 = std::stoll(workerArgs[2]);
+            if (n1 < 0 || n1 >= n2) {
+                std::cerr << "无效的项区间 [" << n1 << ", " << n2 << ")，要求 0 ≤ 起始项 < 结束项" << std::endl;
+                return 1;
+            }
+            return runShardWorker(*constant, n1, n2, workerArgs[3], verify);
+        } catch (const ProductCheckError& e) {
+            std::cerr << "工作进程校验失败：" << e.what() << std::endl;
+            return VERIFY_FAILED_EXIT_CODE;
+        } catch (const std::exception& e) {
+            std::cerr << "工作进程失败: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
+    if (bench) {
+        runBenchmark(benchMaxDigits, benchPiMaxDigits, benchFormat, std::cout);
+        return 0;
+    }
+    
+    const ConstantDefinition* constant = findConstant(algorithm);
+    if ((stream || shards > 0 || maxMemory > 0 || !cacheDir.empty()) && !constant) {
+        if (algorithm != "chudnovsky") {
+            std::cout << "流式输出、分片计算、级数缓存和内存上限只支持常数引擎，改用Chudnovsky二分法" << std::endl;
+        }
+        constant = findConstant("pi");
+    }
+    std::string symbol = constant ? constant->symbol : "π";
+    std::string fileStem = constant ? constant->name : "pi";
+    
+    std::cout << "计算" << symbol << "到小数点后" << digits << "位，使用" << algorithm << "算法" << std::endl;
     
     std::string pi;
+    unsigned long long workerChecks = 0; // 分片工作进程完成的乘法模校验次数
     
-    // 根据选择的算法计算π
-    if (algorithm == "chudnovsky") {
-        pi = calculatePi(digits);
-    } else if (algorithm == "optimized") {
-        pi = calculatePiOptimized(digits);
-    } else if (algorithm == "ramanujan") {
-        pi = calculatePiRamanujan(digits);
-    } else {
-        std::cerr << "未知算法: " << algorithm << std::endl;
-        std::cerr << "支持的算法: chudnovsky, optimized, ramanujan" << std::endl;
+    if (verify) {
+        BigInteger::enableProductCheck();
+    }
+    
+    // 根据选择的算法计算π或其他常数。乘法模校验发现错误时（含后台线程中抛出、经 future 传回的）按校验失败处理
+    try {
+        if (stream) {
+            // 拿到一块就输出一块，同时把完整结果拼起来保存
+            std::cout << symbol << " = " << std::flush;
+            DigitStream digitStream(*constant, digits, streamBlock);
+            std::string block;
+            while (digitStream.next(block)) {
+                std::cout << block << std::flush;
+                pi += block;
+            }
+            std::cout << std::endl;
+        } else if (constant && shards > 0) {
+            pi = calculateConstantSharded(*constant, digits, shards, workerCommand, shardDir, tuningFile, verify, workerChecks);
+        } else if (constant) {
+            pi = calculateConstant(*constant, digits, cacheDir, maxMemory, shardDir);
+        } else if (const MachinFormula* formula = findMachinFormula(algorithm)) {
+            pi = calculatePiMachin(*formula, digits);
+        } else if (algorithm == "chudnovsky") {
+            pi = calculatePi(digits);
+        } else if (algorithm == "optimized") {
+            pi = calculatePiOptimized(digits);
+        } else if (algorithm == "ramanujan") {
+            pi = calculatePiRamanujan(digits);
+        } else {
+            std::cerr << "未知算法: " << algorithm << std::endl;
+            std::cerr << "支持的算法: chudnovsky, optimized, ramanujan, machin, takano, stormer" << std::endl;
+            std::cerr << "支持的常数:";
+            for (const ConstantDefinition& c : builtinConstants()) {
+                std::cerr << " " << c.name;
+            }
+            std::cerr << std::endl;
+            return 1;
+        }
+    } catch (const ProductCheckError& e) {
+        std::cout << std::endl;
+        std::cerr << "校验失败：" << e.what() << std::endl;
+        return VERIFY_FAILED_EXIT_CODE;
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
         return 1;
     }
     
     // 输出结果
-    std::cout << "π = " << pi << std::endl;
+    if (!stream) {
+        std::cout << symbol << " = " << pi << std::endl;
+    }
     
     // 将结果保存到文件
-    std::string filename = "pi_" + std::to_string(digits) + "_digits.txt";
+    std::string filename = fileStem + "_" + std::to_string(digits) + "_digits.txt";
     std::ofstream file(filename);
     if (file.is_open()) {
         file << pi;
@@ -643,5 +1902,32 @@ int main(int argc, char* argv[]) {
         std::cerr << "无法创建文件" << std::endl;
     }
     
+    // 校验：用与所有驱动都独立的BBP公式核对结果尾部（其他常数只做乘法模校验）
+    if (verify && fileStem != "pi") {
+        std::cout << "已完成 " << BigInteger::productChecks() + workerChecks << " 次乘法模校验（BBP尾部校验仅支持π）" << std::endl;
+    } else if (verify) {
+        std::cout << "校验中（BBP公式）..." << std::endl;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        Stats::beginPhase("verify");
+        long long hexPosition = 0;
+        bool passed = verifyPiTail(pi, digits, hexPosition);
+        Stats::endPhase();
+        auto endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsed = endTime - startTime;
+        
+        std::cout << "已完成 " << BigInteger::productChecks() + workerChecks << " 次乘法模校验" << std::endl;
+        
+        if (passed) {
+            std::cout << "校验通过（十六进制第 " << hexPosition << " 位起与BBP公式一致）！用时 " << elapsed.count() << " 秒" << std::endl;
+        } else {
+            std::cerr << "校验失败：十六进制第 " << hexPosition << " 位起与BBP公式结果不一致" << std::endl;
+            return VERIFY_FAILED_EXIT_CODE;
+        }
+    }
+    
+    if (stats) {
+        Stats::writeJson(std::cout, algorithm, digits);
+    }
+    
     return 0;
 }
\ No newline at end of file
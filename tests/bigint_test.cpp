@@ -0,0 +1,141 @@
+// BigInteger 库的回归测试：已知值与随机对拍（牛顿除法对长除法、并行加减对单线程）
+#include "BigInteger.h"
+#include <random>
+#include <sstream>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": 检查失败: " #condition << std::endl; \
+            ++failures;                                                               \
+        }                                                                             \
+    } while (0)
+
+// 首位非零的 n 位随机数；nines 为真时多取9，让进位链更长
+static BigInteger randomNumber(std::mt19937& rng, int n, bool nines = false) {
+    std::string s(1, (char)('1' + rng() % 9));
+    for (int i = 1; i < n; ++i) {
+        s += nines && rng() % 3 ? '9' : (char)('0' + rng() % 10);
+    }
+    return BigInteger(s);
+}
+
+// q·b + r = a，且 0 ≤ |r| < |b|
+static bool isDivision(const BigInteger& a, const BigInteger& b, const std::pair<BigInteger, BigInteger>& qr) {
+    BigInteger absR = qr.second < BigInteger(0) ? BigInteger(0) - qr.second : qr.second;
+    BigInteger absB = b < BigInteger(0) ? BigInteger(0) - b : b;
+    return qr.first * b + qr.second == a && absR < absB;
+}
+
+static void testKnownValues() {
+    BigInteger a("12345678901234567890123456789");
+    BigInteger b("987654321987");
+    CHECK((a / b).toString() == "12499999874852031");
+    CHECK((a % b).toString() == "360868551192");
+    CHECK(((BigInteger(0) - a) / b).toString() == "-12499999874852031");
+    CHECK(((BigInteger(0) - a) % b).toString() == "-360868551192");
+    CHECK((a + b).toString() == "12345678901234568877777778776");
+    CHECK((b - a).toString() == "-12345678901234566902469134802");
+    CHECK((BigInteger("999999999999") + BigInteger(1)).toString() == "1000000000000");
+    CHECK((BigInteger("1000000000000") - BigInteger(1)).toString() == "999999999999");
+
+    CHECK(sqrt(BigInteger(2).scaleByPow10(100)).toString() == "141421356237309504880168872420969807856967187537694");
+    CHECK(sqrt(BigInteger(99)).toString() == "9");
+    CHECK(sqrt(BigInteger(100)).toString() == "10");
+
+    CHECK((BigInteger(1) << 100).toString() == "1267650600228229401496703205376");
+    CHECK((BigInteger("1267650600228229401496703205376") >> 99).toString() == "2");
+    CHECK((BigInteger(-5) << 3).toString() == "-40");
+    CHECK((BigInteger(-41) >> 3).toString() == "-5");
+    CHECK((BigInteger(-41) << -3).toString() == "-5");
+    CHECK((BigInteger(5) >> -40).toString() == "5497558138880");
+    CHECK((BigInteger(12) & BigInteger(10)).toString() == "8");
+    CHECK((BigInteger(12) | BigInteger(10)).toString() == "14");
+}
+
+static void testSerialize(std::mt19937& rng) {
+    for (const BigInteger& value : { BigInteger(0), BigInteger(-7), randomNumber(rng, 1001),
+                                     BigInteger(0) - randomNumber(rng, 64) }) {
+        std::stringstream buffer;
+        value.serialize(buffer);
+        CHECK(BigInteger::deserialize(buffer) == value);
+    }
+    std::stringstream truncated(std::string("\x00\x05", 2));
+    bool threw = false;
+    try {
+        BigInteger::deserialize(truncated);
+    } catch (const std::runtime_error& e) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// 牛顿除法与长除法结果一致；较大的操作数只检查除法恒等式
+static void testDivision(std::mt19937& rng) {
+    const int newtonThreshold = BigInteger::getNewtonDivisionThreshold();
+    for (int i = 0; i < 60; ++i) {
+        BigInteger a = randomNumber(rng, 20 + rng() % 300);
+        BigInteger b = randomNumber(rng, 20 + rng() % 150);
+        if (rng() % 2) {
+            a = BigInteger(0) - a;
+        }
+        BigInteger::setNewtonDivisionThreshold(20);
+        std::pair<BigInteger, BigInteger> newton = a.divmod(b);
+        BigInteger::setNewtonDivisionThreshold(1 << 30);
+        std::pair<BigInteger, BigInteger> schoolbook = a.divmod(b);
+        CHECK(newton.first == schoolbook.first && newton.second == schoolbook.second);
+        CHECK(isDivision(a, b, newton));
+    }
+
+    BigInteger::setNewtonDivisionThreshold(20);
+    for (int i = 0; i < 40; ++i) {
+        BigInteger b = randomNumber(rng, 20 + rng() % 2000);
+        BigInteger a = randomNumber(rng, b.digitCount() + rng() % 2000);
+        CHECK(isDivision(a, b, a.divmod(b)));
+    }
+    // 1276 位除数、精度 1278：修正前牛顿倒数在此发散
+    BigInteger b = randomNumber(rng, 1276);
+    BigInteger a = randomNumber(rng, 2552);
+    CHECK(isDivision(a, b, a.divmod(b)));
+
+    for (int i = 0; i < 5; ++i) {
+        BigInteger n = randomNumber(rng, 100 + rng() % 2500);
+        BigInteger r = sqrt(n);
+        CHECK(r * r <= n && (r + BigInteger(1)) * (r + BigInteger(1)) > n);
+    }
+    BigInteger::setNewtonDivisionThreshold(newtonThreshold);
+}
+
+// 强制走分块并行加减，与单线程结果对拍
+static void testParallelAddSubtract(std::mt19937& rng) {
+    const int addThreshold = BigInteger::getParallelAddThreshold();
+    for (int i = 0; i < 40; ++i) {
+        BigInteger a = randomNumber(rng, 1024 + rng() % 6000, true);
+        BigInteger b = randomNumber(rng, 1 + rng() % 6000, true);
+        BigInteger::setParallelAddThreshold(1 << 30);
+        BigInteger sum = a + b, difference = a - b;
+        BigInteger::setParallelAddThreshold(1024);
+        BigInteger::setParallelAddThreads(2 + rng() % 6);
+        CHECK(a + b == sum);
+        CHECK(a - b == difference);
+        CHECK(b - a == BigInteger(0) - difference);
+        BigInteger::setParallelAddThreads(0);
+    }
+    BigInteger::setParallelAddThreshold(addThreshold);
+}
+
+int main() {
+    std::mt19937 rng(20240611);
+    testKnownValues();
+    testSerialize(rng);
+    testDivision(rng);
+    testParallelAddSubtract(rng);
+    if (failures > 0) {
+        std::cerr << failures << " 项检查失败" << std::endl;
+        return 1;
+    }
+    std::cout << "全部检查通过" << std::endl;
+    return 0;
+}